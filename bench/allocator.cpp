@@ -0,0 +1,61 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// steady-state cache churn: a full map inserts one key and evicts the
+// oldest one per step, the pattern of lru::save once it is at capacity.
+// compares nodes from std::allocator with nodes from pool_allocator.
+// build: g++ -std=c++17 -O2 -I lru bench/allocator.cpp -o bench_allocator
+
+const int capacity = 10000;
+const int steps = 2000000;
+const int lru_steps = 200000;
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+template <class mp>
+void run(const std::string &name) {
+    using value_type = sjtu::pair<int, int>;
+    mp map;
+    for (int i = 0; i < capacity; i++) map.insert(value_type(i, i));
+    auto t = bench_clock::now();
+    for (int i = capacity; i < capacity + steps; i++) {
+        map.insert(value_type(i, i));
+        map.remove(map.begin());
+    }
+    double ms = elapsed_ms(t);
+    std::cout << name << "  " << ms * 1e6 / steps << " ns/step  (" << map.size()
+              << ")" << std::endl;
+}
+
+void run_lru() {
+    using value_type = sjtu::pair<Integer, Matrix<int> >;
+    sjtu::lru cache(capacity);
+    for (int i = 0; i < capacity; i++)
+        cache.save(value_type(Integer(i), Matrix<int>(2, 2, i)));
+    auto t = bench_clock::now();
+    for (int i = capacity; i < capacity + lru_steps; i++)
+        cache.save(value_type(Integer(i), Matrix<int>(2, 2, i)));
+    double ms = elapsed_ms(t);
+    std::cout << "lru::save       pool          " << ms * 1e6 / lru_steps
+              << " ns/step  pooled " << cache.mp.get_allocator().pooled()
+              << std::endl;
+}
+
+template <class Alloc>
+using linked_with =
+    sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>,
+                         sjtu::chained_storage, sjtu::prime_index, Alloc>;
+
+int main() {
+    using value_type = sjtu::pair<const int, int>;
+    run<linked_with<std::allocator<value_type> > >("linked_hashmap  std::allocator");
+    run<linked_with<sjtu::pool_allocator<value_type> > >("linked_hashmap  pool          ");
+    run_lru();
+}
@@ -0,0 +1,72 @@
+#include "async.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// thousands of coroutines in flight at once on one async_lru: each asks
+// for a key of a skewed set, a miss costs a 1 ms loader on the pool.
+// the awaiters of a key share its load, so the loader runs about once
+// per distinct key instead of once per request. the warm run asks for
+// the same keys again: all of them are cached, nothing suspends.
+// build: g++ -std=c++20 -O2 -pthread -I lru bench/async.cpp -o bench_async
+
+const int capacity = 4096;
+const int keys = 4096;
+
+using bench_clock = std::chrono::steady_clock;
+using cache = sjtu::async_lru<int, long long>;
+
+std::atomic<int> loads(0), done(0);
+std::atomic<long long> sink(0);
+
+long long slow_load(int key) {
+    loads++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return key;
+}
+
+sjtu::detached request(cache &c, int key) {
+    sink += co_await c.get_async(key, slow_load);
+    done++;
+}
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+template <class F>
+double issue(int in_flight, F key_of) {
+    done = 0;
+    auto t = bench_clock::now();
+    for (int i = 0; i < in_flight; i++) key_of();
+    while (done.load() < in_flight) std::this_thread::yield();
+    return elapsed_ms(t);
+}
+
+void run(int in_flight) {
+    sjtu::thread_pool pool(8);
+    cache c(capacity, pool);
+    loads = 0;
+    unsigned long long x;
+    auto skewed = [&c, &x]() {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        unsigned long long u = (x >> 33) & (keys - 1);
+        request(c, static_cast<int>(u * u / keys));
+    };
+    x = 1;
+    double cold = issue(in_flight, skewed);
+    int loaded = loads.load();
+    x = 1;
+    double warm = issue(in_flight, skewed);
+    std::cout << "in flight " << in_flight << "  cold " << cold << " ms, "
+              << loaded << " loads  warm " << warm * 1e6 / in_flight
+              << " ns/request, " << loads.load() - loaded << " loads"
+              << std::endl;
+}
+
+int main() {
+    for (int n : {1000, 10000, 100000}) run(n);
+}
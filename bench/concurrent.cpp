@@ -0,0 +1,89 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// throughput of a cache shared by threads: every thread runs the same
+// mix (90% get, 10% save) over skewed keys, from one thread up to the
+// hardware threads. "global" is one basic_lru behind a single mutex,
+// "sharded" is concurrent_lru with 16 shards, whose reads share the
+// shard lock and leave their promotions in a read buffer.
+// build: g++ -std=c++17 -O2 -pthread -I lru bench/concurrent.cpp -o bench_concurrent
+
+const int capacity = 1 << 14;
+const int keys = 1 << 16;
+const int ops = 2000000;
+
+using bench_clock = std::chrono::steady_clock;
+using cache = sjtu::basic_lru<int, int>;
+
+// a few hot keys, a long tail: the square of a uniform number
+int next_key(unsigned long long &x) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    unsigned long long u = (x >> 33) & (keys - 1);
+    return static_cast<int>(u * u / keys);
+}
+
+class global_lru {
+   public:
+    explicit global_lru(size_t size) : c(size) {}
+    bool get(int key, int &out) {
+        std::lock_guard<std::mutex> guard(lock);
+        int *v = c.get(key);
+        if (!v) return false;
+        out = *v;
+        return true;
+    }
+    void save(int key, int value) {
+        std::lock_guard<std::mutex> guard(lock);
+        c.save(key, value);
+    }
+
+   private:
+    std::mutex lock;
+    cache c;
+};
+
+template <class Cache>
+void run(const std::string &name, unsigned threads) {
+    Cache c(capacity);
+    for (int i = 0; i < capacity; i++) c.save(i, i);
+    std::vector<std::thread> pool;
+    std::vector<long long> sinks(threads);
+    auto t = bench_clock::now();
+    for (unsigned id = 0; id < threads; id++) {
+        pool.emplace_back([&c, &sinks, id, threads]() {
+            unsigned long long x = id + 1;
+            long long sink = 0;
+            for (int i = 0; i < ops / static_cast<int>(threads); i++) {
+                int key = next_key(x), v;
+                if (i % 10 == 0) {
+                    c.save(key, i);
+                } else if (c.get(key, v)) {
+                    sink += v;
+                }
+            }
+            sinks[id] = sink;
+        });
+    }
+    for (auto &th : pool) th.join();
+    double s =
+        std::chrono::duration<double>(bench_clock::now() - t).count();
+    long long sink = 0;
+    for (long long v : sinks) sink += v;
+    std::cout << name << " threads " << threads << "  " << ops / s / 1e6
+              << " Mops/s  (" << sink << ")" << std::endl;
+}
+
+int main() {
+    unsigned most = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1;; threads *= 2) {
+        if (threads > most) threads = most;
+        run<global_lru>("global ", threads);
+        run<sjtu::concurrent_lru<int, int> >("sharded", threads);
+        if (threads == most) break;
+    }
+}
@@ -0,0 +1,113 @@
+#include "src.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// a read-mostly lookup table: reader threads look up random keys while
+// one writer keeps replacing values. "locked" is a chained hashmap
+// behind a shared_mutex, "epoch" is concurrent_hashmap, whose readers
+// take no lock at all.
+// the grow run has every thread insert its own keys into an empty
+// concurrent_hashmap, so the map keeps growing under them and the
+// threads share the moving of the buckets.
+// build: g++ -std=c++17 -O2 -pthread -I lru bench/concurrent_hashmap.cpp -o bench_concurrent_hashmap
+
+const int keys = 1 << 16;
+const int lookups = 4000000;
+
+using bench_clock = std::chrono::steady_clock;
+
+class locked_map {
+   public:
+    bool find(int key, int &out) const {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        auto it = map.find(key);
+        if (it == map.end()) return false;
+        out = (*it).second;
+        return true;
+    }
+    void insert_or_assign(int key, int value) {
+        std::lock_guard<std::shared_mutex> guard(lock);
+        map.insert(sjtu::pair<int, int>(key, value));
+    }
+
+   private:
+    mutable std::shared_mutex lock;
+    sjtu::hashmap<int, int> map;
+};
+
+template <class Map>
+void run(const std::string &name, unsigned readers) {
+    Map map;
+    for (int i = 0; i < keys; i++) map.insert_or_assign(i, i);
+    std::atomic<bool> stop(false);
+    std::thread writer([&map, &stop]() {
+        for (int i = 0; !stop.load(std::memory_order_relaxed); i++) {
+            map.insert_or_assign(i & (keys - 1), i);
+            std::this_thread::yield();
+        }
+    });
+    std::vector<std::thread> pool;
+    std::vector<long long> sinks(readers);
+    auto t = bench_clock::now();
+    for (unsigned id = 0; id < readers; id++) {
+        pool.emplace_back([&map, &sinks, id, readers]() {
+            unsigned long long x = id + 1;
+            long long sink = 0;
+            for (int i = 0; i < lookups / static_cast<int>(readers); i++) {
+                x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+                int v;
+                if (map.find(static_cast<int>((x >> 33) & (keys - 1)), v))
+                    sink += v;
+            }
+            sinks[id] = sink;
+        });
+    }
+    for (auto &th : pool) th.join();
+    double s =
+        std::chrono::duration<double>(bench_clock::now() - t).count();
+    stop.store(true);
+    writer.join();
+    long long sink = 0;
+    for (long long v : sinks) sink += v;
+    std::cout << name << " readers " << readers << "  " << lookups / s / 1e6
+              << " Mlookups/s  (" << (sink != 0) << ")" << std::endl;
+}
+
+void grow(unsigned threads) {
+    const int n = 1 << 20;
+    sjtu::concurrent_hashmap<int, int> map;
+    std::vector<std::thread> pool;
+    auto t = bench_clock::now();
+    for (unsigned id = 0; id < threads; id++) {
+        pool.emplace_back([&map, id, threads]() {
+            for (int i = id; i < n; i += threads) map.insert_or_assign(i, i);
+        });
+    }
+    for (auto &th : pool) th.join();
+    std::cout << "grow   threads " << threads << "  "
+              << std::chrono::duration<double, std::milli>(bench_clock::now() -
+                                                           t)
+                     .count()
+              << " ms  (" << map.size() << " keys, " << map.bucket_count()
+              << " buckets)" << std::endl;
+}
+
+int main() {
+    unsigned most = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned readers = 1;; readers *= 2) {
+        if (readers > most) readers = most;
+        run<locked_map>("locked", readers);
+        run<sjtu::concurrent_hashmap<int, int> >("epoch ", readers);
+        if (readers == most) break;
+    }
+    for (unsigned threads = 1;; threads *= 2) {
+        if (threads > most) threads = most;
+        grow(threads);
+        if (threads == most) break;
+    }
+}
@@ -0,0 +1,101 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// random lookups into tables far larger than the last level cache, in
+// batches of 1 to 256 keys: a loop of single find / get against
+// find_many / get_many, which prefetch the buckets and nodes of a whole
+// batch before comparing any key.
+// build: g++ -std=c++17 -O2 -I lru bench/find_many.cpp -o bench_find_many
+
+const int n = 1 << 23;
+const int queries = 1 << 20;
+const int batches[] = {1, 4, 16, 64, 256};
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+// keys 0..2n-1 in random order, half of them missing
+std::vector<int> random_keys() {
+    std::vector<int> keys(queries);
+    unsigned long long x = 88172645463325252ULL;
+    for (int &k : keys) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        k = static_cast<int>(x % (2ULL * n));
+    }
+    return keys;
+}
+
+template <class mp>
+void run_map(const std::string &name, const std::vector<int> &keys) {
+    mp map;
+    map.reserve(n);
+    for (int i = 0; i < n; i++) map.insert(typename mp::value_type(i, i));
+    std::vector<typename mp::iterator> out(256);
+    for (int b : batches) {
+        long long sink = 0;
+        auto t = bench_clock::now();
+        for (int q = 0; q < queries; q += b) {
+            for (int i = 0; i < b; i++) {
+                auto it = map.find(keys[q + i]);
+                if (it != map.end()) sink += (*it).second;
+            }
+        }
+        double single = elapsed_ms(t);
+        t = bench_clock::now();
+        for (int q = 0; q < queries; q += b) {
+            map.find_many(&keys[q], b, out.data());
+            for (int i = 0; i < b; i++) {
+                if (out[i] != map.end()) sink += (*out[i]).second;
+            }
+        }
+        double many = elapsed_ms(t);
+        std::cout << name << "  batch " << b << "  find " << single
+                  << " ms  find_many " << many << " ms  (" << sink << ")"
+                  << std::endl;
+    }
+}
+
+void run_lru(const std::vector<int> &keys) {
+    sjtu::basic_lru<int, int> cache(n);
+    for (int i = 0; i < n; i++) cache.save(sjtu::pair<const int, int>(i, i));
+    std::vector<int *> out(256);
+    for (int b : batches) {
+        long long sink = 0;
+        auto t = bench_clock::now();
+        for (int q = 0; q < queries; q += b) {
+            for (int i = 0; i < b; i++) {
+                if (int *v = cache.get(keys[q + i])) sink += *v;
+            }
+        }
+        double single = elapsed_ms(t);
+        t = bench_clock::now();
+        for (int q = 0; q < queries; q += b) {
+            cache.get_many(&keys[q], b, out.data());
+            for (int i = 0; i < b; i++) {
+                if (out[i]) sink += *out[i];
+            }
+        }
+        double many = elapsed_ms(t);
+        std::cout << "lru                 batch " << b << "  get " << single
+                  << " ms  get_many " << many << " ms  (" << sink << ")"
+                  << std::endl;
+    }
+}
+
+int main() {
+    std::vector<int> keys = random_keys();
+    run_map<sjtu::linked_hashmap<int, int> >("linked_hashmap chained", keys);
+    run_map<sjtu::linked_hashmap<int, int, std::hash<int>,
+                                 std::equal_to<int>, sjtu::swiss_storage> >(
+        "linked_hashmap swiss  ", keys);
+    run_lru(keys);
+}
@@ -0,0 +1,80 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// string keys with a long shared prefix, with and without the full hash
+// cached in every node (sjtu::cache_hash)
+// build: g++ -std=c++17 -O2 -I lru bench/hash_cache.cpp -o bench_hash_cache
+
+const int n = 200000;
+const int rounds = 5;
+
+class PlainHash {
+   public:
+    size_t operator()(const std::string &s) const {
+        return std::hash<std::string>()(s);
+    }
+};
+namespace sjtu {
+template <>
+struct cache_hash<PlainHash> : std::false_type {};
+}
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+std::vector<std::string> make_keys(int from, int to) {
+    std::vector<std::string> keys;
+    for (int i = from; i < to; ++i) {
+        keys.push_back("/api/v1/users/profile/settings/" + std::to_string(i));
+    }
+    return keys;
+}
+
+template <class mp>
+void run(const std::string &name) {
+    using value_type = sjtu::pair<std::string, int>;
+    std::vector<std::string> hits = make_keys(0, n);
+    std::vector<std::string> misses = make_keys(n, 2 * n);
+    double t_insert = 0, t_expand = 0, t_hit = 0, t_miss = 0;
+    long long sink = 0;
+    for (int r = 0; r < rounds; ++r) {
+        mp map;
+        auto t = bench_clock::now();
+        for (int i = 0; i < n; i++) map.insert(value_type(hits[i], i));
+        t_insert += elapsed_ms(t);
+
+        t = bench_clock::now();
+        map.expand();
+        t_expand += elapsed_ms(t);
+
+        t = bench_clock::now();
+        for (int i = 0; i < n; i++) sink += (*map.find(hits[i])).second;
+        t_hit += elapsed_ms(t);
+
+        t = bench_clock::now();
+        for (int i = 0; i < n; i++) sink += map.find(misses[i]) == map.end();
+        t_miss += elapsed_ms(t);
+    }
+    std::cout << name << "  insert " << t_insert / rounds << " ms  expand "
+              << t_expand / rounds << " ms  find hit " << t_hit / rounds
+              << " ms  find miss " << t_miss / rounds << " ms  (" << sink
+              << ")" << std::endl;
+}
+
+int main() {
+    using cached = std::hash<std::string>;
+    using equal = std::equal_to<std::string>;
+    run<sjtu::hashmap<std::string, int, cached, equal> >("chained cached");
+    run<sjtu::hashmap<std::string, int, PlainHash, equal> >("chained plain ");
+    run<sjtu::hashmap<std::string, int, cached, equal, sjtu::swiss_storage> >(
+        "swiss   cached");
+    run<sjtu::hashmap<std::string, int, PlainHash, equal,
+                      sjtu::swiss_storage> >("swiss   plain ");
+}
@@ -0,0 +1,77 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// the 100k-key workload of test/1.cpp, timed phase by phase.
+// the strided run feeds the same workload with keys i * 1024, which the
+// identity std::hash<int> piles into a few chained buckets unless the
+// bucket index policy mixes the hash.
+// build: g++ -std=c++17 -O2 -I lru bench/hashmap.cpp -o bench_hashmap
+
+const int seq_n = 100000;
+const int strided_n = 10000;
+const int rounds = 20;
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+template <class mp>
+void run(const std::string &name, bool strided) {
+    using value_type = sjtu::pair<int, int>;
+    const int n = strided ? strided_n : seq_n;
+    const int step = strided ? 1024 : 1;
+    double t_insert = 0, t_update = 0, t_remove = 0, t_find = 0;
+    long long sink = 0;
+    for (int r = 0; r < rounds; ++r) {
+        mp map;
+        auto t = bench_clock::now();
+        for (int i = 0; i < n; i++) map.insert(value_type(i * step, i));
+        t_insert += elapsed_ms(t);
+
+        t = bench_clock::now();
+        for (int i = 0; i < n; i += 4) map.insert(value_type(i * step, 4 * i));
+        t_update += elapsed_ms(t);
+
+        t = bench_clock::now();
+        for (int i = 0; i < n; i += 3) map.remove(i * step);
+        t_remove += elapsed_ms(t);
+
+        t = bench_clock::now();
+        for (int i = 0; i < n; i++) {
+            auto it = map.find(i * step);
+            if (it != map.end()) sink += (*it).second;
+        }
+        t_find += elapsed_ms(t);
+    }
+    std::cout << name << "  insert " << t_insert / rounds << " ms  update "
+              << t_update / rounds << " ms  remove " << t_remove / rounds
+              << " ms  find " << t_find / rounds << " ms  (" << sink << ")"
+              << std::endl;
+}
+
+template <class Index>
+using chained_with = sjtu::hashmap<int, int, std::hash<int>,
+                                   std::equal_to<int>, sjtu::chained_storage,
+                                   Index>;
+
+int main() {
+    using swiss = sjtu::hashmap<int, int, std::hash<int>, std::equal_to<int>,
+                                sjtu::swiss_storage>;
+    for (bool strided : {false, true}) {
+        std::string tag = strided ? "strided    " : "sequential ";
+        run<chained_with<sjtu::mod_index> >(tag + "chained  mod      ",
+                                            strided);
+        run<chained_with<sjtu::fibonacci_index> >(
+            tag + "chained  fibonacci", strided);
+        run<chained_with<sjtu::murmur_index> >(tag + "chained  murmur   ",
+                                               strided);
+        run<chained_with<sjtu::prime_index> >(tag + "chained  prime    ",
+                                              strided);
+        run<swiss>(tag + "swiss             ", strided);
+    }
+}
@@ -0,0 +1,99 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// hit ratio and cost of every eviction policy, W-TinyLFU admission
+// included, on the same key traces.
+// a miss saves the key, as a read-through cache would.
+//   zipf: skewed keys, a hot working set
+//   zipf + scans: the same, every few thousand requests a run of keys
+//     that are never seen again sweeps through
+//   loop: keys 0..n-1 over and over, n a bit above the capacity
+// build: g++ -std=c++17 -O2 -I lru bench/hit_ratio.cpp -o bench_hit_ratio
+
+const int capacity = 1000;
+const int requests = 2000000;
+const int universe = 100000;
+
+using bench_clock = std::chrono::steady_clock;
+
+/**
+ * zipf(0.9) samples by inverting the cumulative weights
+ */
+class zipf {
+   public:
+    zipf(int n, double s) : cdf(n) {
+        double sum = 0;
+        for (int i = 0; i < n; i++) cdf[i] = sum += 1 / std::pow(i + 1.0, s);
+        for (int i = 0; i < n; i++) cdf[i] /= sum;
+    }
+    int operator()(std::mt19937 &rng) {
+        double u = std::uniform_real_distribution<double>(0, 1)(rng);
+        return std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+    }
+
+   private:
+    std::vector<double> cdf;
+};
+
+std::vector<int> zipf_trace(bool scans) {
+    std::mt19937 rng(2024);
+    zipf dist(universe, 0.9);
+    std::vector<int> trace;
+    int fresh = universe;
+    while ((int)trace.size() < requests) {
+        if (scans && trace.size() % 5000 == 0) {
+            for (int i = 0; i < 2 * capacity; i++) trace.push_back(fresh++);
+        } else {
+            trace.push_back(dist(rng));
+        }
+    }
+    trace.resize(requests);
+    return trace;
+}
+
+std::vector<int> loop_trace() {
+    std::vector<int> trace(requests);
+    for (int i = 0; i < requests; i++) trace[i] = i % (capacity * 5 / 4);
+    return trace;
+}
+
+template <class Policy>
+void run(const std::string &name, const std::vector<int> &trace) {
+    sjtu::basic_lru<int, int, std::hash<int>, std::equal_to<int>, size_t,
+                    Policy>
+        cache(capacity);
+    long long hits = 0;
+    auto t = bench_clock::now();
+    for (int key : trace) {
+        if (cache.get(key))
+            hits++;
+        else
+            cache.save(key, key);
+    }
+    double ms =
+        std::chrono::duration<double, std::milli>(bench_clock::now() - t)
+            .count();
+    std::cout << name << "  hit " << 100.0 * hits / trace.size() << "%  "
+              << ms * 1e6 / trace.size() << " ns/request" << std::endl;
+}
+
+void run_all(const std::string &title, const std::vector<int> &trace) {
+    std::cout << title << std::endl;
+    run<sjtu::lru_policy>("  lru      ", trace);
+    run<sjtu::clock_policy>("  clock    ", trace);
+    run<sjtu::slru_policy>("  slru     ", trace);
+    run<sjtu::two_queue_policy>("  2q       ", trace);
+    run<sjtu::arc_policy>("  arc      ", trace);
+    run<sjtu::lfu_policy>("  lfu      ", trace);
+    run<sjtu::w_tinylfu_policy>("  w-tinylfu", trace);
+}
+
+int main() {
+    run_all("zipf", zipf_trace(false));
+    run_all("zipf + scans", zipf_trace(true));
+    run_all("loop", loop_trace());
+}
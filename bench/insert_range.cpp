@@ -0,0 +1,78 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// cold start of a linked_hashmap from a snapshot of 1M pairs: a loop of
+// insert against insert_range, which sizes the table once, chains the
+// list in one pass and, with pool_allocator, takes the nodes from one
+// block.
+// build: g++ -std=c++17 -O2 -I lru bench/insert_range.cpp -o bench_insert_range
+
+const int n = 1000000;
+const int rounds = 5;
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+template <class mp>
+void run(const std::string &name,
+         const std::vector<sjtu::pair<int, int> > &v) {
+    using value_type = typename mp::value_type;
+    double t_loop = 0, t_range = 0, t_walk_loop = 0, t_walk_range = 0;
+    long long sink = 0;
+    for (int r = 0; r < rounds; ++r) {
+        {
+            mp map;
+            auto t = bench_clock::now();
+            for (auto &e : v) map.insert(value_type(e.first, e.second));
+            t_loop += elapsed_ms(t);
+            t = bench_clock::now();
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                sink += (*it).second;
+            }
+            t_walk_loop += elapsed_ms(t);
+        }
+        {
+            auto t = bench_clock::now();
+            mp map(v.begin(), v.end());
+            t_range += elapsed_ms(t);
+            t = bench_clock::now();
+            for (auto it = map.begin(); it != map.end(); ++it) {
+                sink += (*it).second;
+            }
+            t_walk_range += elapsed_ms(t);
+        }
+    }
+    std::cout << name << "  insert loop " << t_loop / rounds
+              << " ms  insert_range " << t_range / rounds << " ms  walk "
+              << t_walk_loop / rounds << " / " << t_walk_range / rounds
+              << " ms  (" << sink << ")" << std::endl;
+}
+
+template <class Storage, class Alloc>
+using linked_with = sjtu::linked_hashmap<int, int, std::hash<int>,
+                                         std::equal_to<int>, Storage,
+                                         sjtu::prime_index, Alloc>;
+
+int main() {
+    using std_alloc = std::allocator<sjtu::pair<const int, int> >;
+    using pool = sjtu::pool_allocator<sjtu::pair<const int, int> >;
+    std::vector<sjtu::pair<int, int> > v;
+    // a snapshot in the order of the cache, keys scattered
+    for (int i = 0; i < n; i++) {
+        v.push_back(sjtu::pair<int, int>(i * 7919LL % n, i));
+    }
+    run<linked_with<sjtu::chained_storage, std_alloc> >(
+        "chained std::allocator", v);
+    run<linked_with<sjtu::chained_storage, pool> >("chained pool_allocator",
+                                                   v);
+    run<linked_with<sjtu::swiss_storage, std_alloc> >("swiss   std::allocator",
+                                                      v);
+    run<linked_with<sjtu::swiss_storage, pool> >("swiss   pool_allocator", v);
+}
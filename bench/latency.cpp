@@ -0,0 +1,43 @@
+#include "src.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// per-insert latency while a map grows from empty to n keys,
+// every expand() of the chained and swiss engines shows up in the tail
+// build: g++ -std=c++17 -O2 -I lru bench/latency.cpp -o bench_latency
+
+const int n = 1000000;
+
+using bench_clock = std::chrono::steady_clock;
+
+template <class mp>
+void run(const std::string &name) {
+    using value_type = sjtu::pair<int, int>;
+    std::vector<double> lat(n);
+    mp map;
+    for (int i = 0; i < n; i++) {
+        auto t = bench_clock::now();
+        map.insert(value_type(i, i));
+        lat[i] = std::chrono::duration<double, std::micro>(bench_clock::now() -
+                                                           t)
+                     .count();
+    }
+    double total = 0;
+    for (double x : lat) total += x;
+    std::sort(lat.begin(), lat.end());
+    std::cout << name << "  total " << total / 1000 << " ms  p50 "
+              << lat[n / 2] << " us  p99 " << lat[n / 100 * 99]
+              << " us  p999 " << lat[n / 1000 * 999] << " us  max "
+              << lat[n - 1] << " us" << std::endl;
+}
+
+int main() {
+    run<sjtu::hashmap<int, int> >("chained    ");
+    run<sjtu::hashmap<int, int, std::hash<int>, std::equal_to<int>,
+                      sjtu::incremental_storage> >("incremental");
+    run<sjtu::hashmap<int, int, std::hash<int>, std::equal_to<int>,
+                      sjtu::swiss_storage> >("swiss      ");
+}
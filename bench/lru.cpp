@@ -0,0 +1,58 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// the cache-hit path of lru::get. the workload of test/8.cpp (save a
+// key, get a key that is still cached), then a pure hit loop over a
+// full cache. get_by_copy is the old hit path kept here for comparison:
+// copy the value out, remove, insert the copy, look it up again.
+// build: g++ -std=c++17 -O2 -I lru bench/lru.cpp -o bench_lru
+
+const int capacity = 100;
+const int n = 10000;
+const int hits = 1000000;
+
+using bench_clock = std::chrono::steady_clock;
+using value_type = sjtu::pair<Integer, Matrix<int> >;
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+Matrix<int> *get_by_copy(sjtu::lru &cache, const Integer &v) {
+    auto it = cache.mp.find(v);
+    if (it == cache.mp.end()) return nullptr;
+    auto val = it->second;
+    cache.mp.remove(it);
+    cache.mp.insert({v, val});
+    return &(cache.mp.at(v));
+}
+
+template <class Get>
+void run(const std::string &name, Get get) {
+    long long sink = 0;
+    sjtu::lru cache(capacity);
+    auto t = bench_clock::now();
+    for (int i = 0; i < n; i++) {
+        cache.save(value_type(Integer(i), Matrix<int>(2, 2, i)));
+        sink += (*get(cache, Integer(i - (i % 99))))[0][0];
+    }
+    double t_mixed = elapsed_ms(t);
+
+    t = bench_clock::now();
+    for (int i = 0; i < hits; i++) {
+        sink += (*get(cache, Integer(n - 1 - i % capacity)))[1][1];
+    }
+    double t_hit = elapsed_ms(t);
+    std::cout << name << "  test/8 workload " << t_mixed << " ms  hit "
+              << t_hit * 1e6 / hits << " ns  (" << sink << ")" << std::endl;
+}
+
+int main() {
+    run("lru::get    ", [](sjtu::lru &cache, const Integer &v) {
+        return cache.get(v);
+    });
+    run("get_by_copy ", get_by_copy);
+}
@@ -0,0 +1,67 @@
+#include "src.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// per-save latency of a full cache of 64x64 matrices: every save evicts
+// one. "inline" is a basic_lru behind a mutex, which frees the evicted
+// matrix inside save; "background" is maintained_lru, whose thread
+// evicts and frees them.
+// build: g++ -std=c++17 -O2 -pthread -I lru bench/maintenance.cpp -o bench_maintenance
+
+const int capacity = 1024;
+const int n = 100000;
+const size_t side = 64;
+
+using bench_clock = std::chrono::steady_clock;
+using cache = sjtu::basic_lru<int, Matrix<int> >;
+
+class inline_lru {
+   public:
+    explicit inline_lru(size_t size) : c(size) {}
+    template <class K, class V>
+    void save(K &&key, V &&value) {
+        std::lock_guard<std::mutex> guard(lock);
+        c.save(std::forward<K>(key), std::forward<V>(value));
+    }
+
+   private:
+    std::mutex lock;
+    cache c;
+};
+
+template <class Cache>
+void run(const std::string &name, Cache &c) {
+    std::vector<double> lat(n);
+    const Matrix<int> value(side, side, 1);
+    for (int i = 0; i < capacity; i++) c.save(i, value);
+    for (int i = 0; i < n; i++) {
+        auto t = bench_clock::now();
+        c.save(capacity + i, value);
+        lat[i] = std::chrono::duration<double, std::micro>(bench_clock::now() -
+                                                           t)
+                     .count();
+    }
+    double total = 0;
+    for (double x : lat) total += x;
+    std::sort(lat.begin(), lat.end());
+    std::cout << name << "  total " << total / 1000 << " ms  p50 "
+              << lat[n / 2] << " us  p99 " << lat[n / 100 * 99]
+              << " us  p999 " << lat[n / 1000 * 999] << " us  max "
+              << lat[n - 1] << " us" << std::endl;
+}
+
+int main() {
+    {
+        inline_lru c(capacity);
+        run("inline    ", c);
+    }
+    {
+        sjtu::maintained_lru<cache> c(capacity / 4,
+                                      std::chrono::milliseconds(1), capacity);
+        run("background", c);
+    }
+}
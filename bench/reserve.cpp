@@ -0,0 +1,68 @@
+#include "src.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// filling a table of n keys as it grows from init_cnt buckets, against
+// reserve(n) first, then removing all but 1% of the keys and timing
+// lookups before and after shrink_to_fit gives the buckets back.
+// build: g++ -std=c++17 -O2 -I lru bench/reserve.cpp -o bench_reserve
+
+const int n = 1000000;
+const int rounds = 5;
+
+using bench_clock = std::chrono::steady_clock;
+
+double elapsed_ms(bench_clock::time_point from) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - from)
+        .count();
+}
+
+template <class mp>
+void run(const std::string &name) {
+    using value_type = typename mp::value_type;
+    double t_grow = 0, t_reserved = 0, t_before = 0, t_after = 0;
+    size_t big = 0, small = 0;
+    long long sink = 0;
+    for (int r = 0; r < rounds; ++r) {
+        {
+            mp map;
+            auto t = bench_clock::now();
+            for (int i = 0; i < n; i++) map.insert(value_type(i, i));
+            t_grow += elapsed_ms(t);
+        }
+        mp map;
+        auto t = bench_clock::now();
+        map.reserve(n);
+        for (int i = 0; i < n; i++) map.insert(value_type(i, i));
+        t_reserved += elapsed_ms(t);
+
+        for (int i = 0; i < n; i++) {
+            if (i % 100) map.remove(map.find(i));
+        }
+        big = map.bucket_count();
+        t = bench_clock::now();
+        for (int i = 0; i < n; i += 100) sink += (*map.find(i)).second;
+        t_before += elapsed_ms(t);
+        map.shrink_to_fit();
+        small = map.bucket_count();
+        t = bench_clock::now();
+        for (int i = 0; i < n; i += 100) sink += (*map.find(i)).second;
+        t_after += elapsed_ms(t);
+    }
+    std::cout << name << "  insert " << t_grow / rounds << " ms  reserved "
+              << t_reserved / rounds << " ms  purged find "
+              << t_before / rounds << " ms (" << big << " buckets)  shrunk "
+              << t_after / rounds << " ms (" << small << " buckets)  ("
+              << sink << ")" << std::endl;
+}
+
+template <class Storage>
+using linked_with = sjtu::linked_hashmap<int, int, std::hash<int>,
+                                         std::equal_to<int>, Storage>;
+
+int main() {
+    run<linked_with<sjtu::chained_storage> >("chained    ");
+    run<linked_with<sjtu::incremental_storage> >("incremental");
+    run<linked_with<sjtu::swiss_storage> >("swiss      ");
+}
@@ -0,0 +1,151 @@
+#ifndef SJTU_ALLOCATOR_HPP
+#define SJTU_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * allocator of bucket arrays, calloc hands back zeroed memory
+ * (fresh pages for big arrays, without touching them) so building
+ * a vector of n null pointers costs no fill loop
+ */
+template <class T>
+class zeroed_allocator {
+   public:
+    using value_type = T;
+    zeroed_allocator() {}
+    template <class U>
+    zeroed_allocator(const zeroed_allocator<U> &) {}
+    T *allocate(size_t n) {
+        void *p = std::calloc(n, sizeof(T));
+        if (!p) throw std::bad_alloc();
+        return static_cast<T *>(p);
+    }
+    void deallocate(T *p, size_t) { std::free(p); }
+    // value-initializing a pointer would write the zero calloc gave
+    template <class U>
+    void construct(U *) {}
+    template <class U, class... Args>
+    void construct(U *p, Args &&...args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+    bool operator==(const zeroed_allocator &) const { return true; }
+    bool operator!=(const zeroed_allocator &) const { return false; }
+};
+
+/**
+ * fixed-size slab pool for container nodes
+ * single objects are carved out of slabs that double in size up to
+ * max_slab objects, a freed object goes on a free list and is handed
+ * out again by the next allocate, so a container that removes one
+ * node and inserts one node does not touch the heap at all.
+ * every copy or rebind starts an empty pool of its own: memory from
+ * one pool_allocator must go back to that same allocator object.
+ * arrays (n != 1) bypass the pool.
+ */
+template <class T>
+class pool_allocator {
+   public:
+    using value_type = T;
+    static const size_t first_slab = 16;
+    static const size_t max_slab = 4096;
+
+    pool_allocator() {}
+    pool_allocator(const pool_allocator &) {}
+    template <class U>
+    pool_allocator(const pool_allocator<U> &) {}
+    pool_allocator &operator=(const pool_allocator &) { return *this; }
+    ~pool_allocator() {
+        while (slabs) {
+            slot *prev = slabs->next;
+            ::operator delete(slabs);
+            slabs = prev;
+        }
+    }
+
+    T *allocate(size_t n) {
+        if (n != 1) return static_cast<T *>(::operator new(n * sizeof(T)));
+        if (free_list) {
+            slot *s = free_list;
+            free_list = s->next;
+            --free_cnt;
+            return reinterpret_cast<T *>(s);
+        }
+        if (cursor == last) grow();
+        return reinterpret_cast<T *>(cursor++);
+    }
+    void deallocate(T *p, size_t n) {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        slot *s = reinterpret_cast<slot *>(p);
+        s->next = free_list;
+        free_list = s;
+        ++free_cnt;
+    }
+    /**
+     * room for n more objects, so that a bulk insertion carves its
+     * nodes one after the other instead of growing slab by slab.
+     * the free list is handed out first and counts toward n, what is
+     * left of the current slab joins it and the rest is one new slab
+     */
+    void reserve(size_t n) {
+        if (n <= free_cnt) return;
+        n -= free_cnt;
+        size_t left = last - cursor;
+        if (left >= n) return;
+        // pushed from the end, so they are handed out in address order
+        while (last != cursor) {
+            --last;
+            last->next = free_list;
+            free_list = last;
+        }
+        free_cnt += left;
+        grow(n - left + 1);
+    }
+    /**
+     * objects carved out of the slabs so far, live or on the free list
+     */
+    size_t pooled() const { return carved; }
+
+    bool operator==(const pool_allocator &rhs) const { return this == &rhs; }
+    bool operator!=(const pool_allocator &rhs) const { return this != &rhs; }
+
+   private:
+    union slot {
+        slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    /**
+     * the first slot of every slab links the previous slab
+     */
+    void grow() {
+        grow(next_slab);
+        if (next_slab < max_slab) next_slab *= 2;
+    }
+    void grow(size_t size) {
+        slot *slab = static_cast<slot *>(::operator new(size * sizeof(slot)));
+        slab->next = slabs;
+        slabs = slab;
+        cursor = slab + 1;
+        last = slab + size;
+        carved += size - 1;
+    }
+
+    slot *free_list = nullptr;
+    slot *cursor = nullptr;
+    slot *last = nullptr;
+    slot *slabs = nullptr;
+    size_t next_slab = first_slab;
+    size_t carved = 0;
+    size_t free_cnt = 0;
+};
+
+}  // namespace sjtu
+
+#endif
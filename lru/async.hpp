@@ -0,0 +1,241 @@
+#ifndef SJTU_ASYNC_HPP
+#define SJTU_ASYNC_HPP
+
+// C++20 coroutines on top of lru.hpp, build with -std=c++20
+#include "lru.hpp"
+
+#if defined(__cpp_impl_coroutine)
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace sjtu {
+
+/**
+ * a coroutine nobody waits for: it runs at once and frees itself when
+ * it returns. an exception escaping it ends the program.
+ */
+struct detached {
+    struct promise_type {
+        detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/**
+ * threads resuming coroutines: co_await pool.schedule() moves the
+ * rest of a coroutine onto one of them.
+ * the destructor runs what is still queued, then joins.
+ */
+class thread_pool {
+   public:
+    explicit thread_pool(unsigned threads) : stopping(false) {
+        for (unsigned i = 0; i < std::max(threads, 1u); ++i) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto &t : workers) t.join();
+    }
+
+    size_t size() const { return workers.size(); }
+    /**
+     * resume h on a thread of the pool
+     */
+    void post(std::coroutine_handle<> h) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push_back(h);
+        }
+        ready.notify_one();
+    }
+    auto schedule() {
+        struct awaiter {
+            thread_pool *pool;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { pool->post(h); }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{this};
+    }
+
+   private:
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::coroutine_handle<> > queue;
+    std::vector<std::thread> workers;
+    bool stopping;
+
+    void work() {
+        for (;;) {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                ready.wait(guard, [this]() { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                h = queue.front();
+                queue.pop_front();
+            }
+            h.resume();
+        }
+    }
+};
+
+/**
+ * a basic_lru for coroutines: co_await cache.get_async(key, loader)
+ * gives the value of key. a hit does not suspend. a miss suspends,
+ * loader(key) runs on the thread pool and the coroutine is resumed
+ * there once the value is saved. awaiters missing a key that is
+ * already being loaded wait for that same load, an exception of
+ * loader is thrown to all of them and nothing is saved.
+ * the cache must outlive the loads it started.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key>, class Size = size_t,
+          class Policy = lru_policy>
+class async_lru {
+    // a load in progress and the coroutines waiting for it
+    struct flight {
+        std::vector<std::coroutine_handle<> > waiters;
+        std::optional<Value> value;
+        std::exception_ptr error;
+    };
+
+   public:
+    using value_type = sjtu::pair<const Key, Value>;
+
+    async_lru(Size size, thread_pool &pool) : cache(size), pool(pool) {}
+    async_lru(const async_lru &) = delete;
+    async_lru &operator=(const async_lru &) = delete;
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard(lock);
+        return cache.size();
+    }
+    void save(const value_type &v) {
+        std::lock_guard<std::mutex> guard(lock);
+        cache.save(v);
+    }
+    /**
+     * copy the value of key into out without loading it,
+     * return false on a miss
+     */
+    bool get(const Key &key, Value &out) {
+        std::lock_guard<std::mutex> guard(lock);
+        Value *value = cache.get(key);
+        if (!value) return false;
+        out = *value;
+        return true;
+    }
+
+    template <class Loader>
+    class get_awaiter {
+       public:
+        get_awaiter(async_lru *owner, const Key &key, Loader loader)
+            : owner(owner), key(key), loader(std::move(loader)) {}
+
+        bool await_ready() {
+            std::lock_guard<std::mutex> guard(owner->lock);
+            return hit();
+        }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::shared_ptr<flight> fresh;
+            {
+                std::lock_guard<std::mutex> guard(owner->lock);
+                // loaded since await_ready
+                if (hit()) return false;
+                auto it = owner->flights.find(key);
+                if (it != owner->flights.end()) {
+                    joined = (*it).second;
+                    joined->waiters.push_back(h);
+                    return true;
+                }
+                fresh = std::make_shared<flight>();
+                fresh->waiters.push_back(h);
+                joined = fresh;
+                owner->flights.insert(
+                    typename flight_map::value_type(key, fresh));
+            }
+            // h may already be resumed when load returns,
+            // this awaiter must not be touched any more
+            owner->load(key, loader, std::move(fresh));
+            return true;
+        }
+        Value await_resume() {
+            if (result) return std::move(*result);
+            if (joined->error) std::rethrow_exception(joined->error);
+            return *joined->value;
+        }
+
+       private:
+        async_lru *owner;
+        Key key;
+        Loader loader;
+        std::optional<Value> result;
+        std::shared_ptr<flight> joined;
+
+        bool hit() {
+            Value *value = owner->cache.get(key);
+            if (value) result.emplace(*value);
+            return value != nullptr;
+        }
+    };
+    /**
+     * co_await it for the value of key, see the class
+     */
+    template <class Loader>
+    get_awaiter<Loader> get_async(const Key &key, Loader loader) {
+        return get_awaiter<Loader>(this, key, std::move(loader));
+    }
+
+   private:
+    using flight_map = hashmap<Key, std::shared_ptr<flight>, Hash, Equal>;
+
+    basic_lru<Key, Value, Hash, Equal, Size, Policy> cache;
+    // the keys being loaded
+    flight_map flights;
+    std::mutex lock;
+    thread_pool &pool;
+
+    // the arguments are copied into the frame before it suspends
+    template <class Loader>
+    detached load(Key key, Loader loader, std::shared_ptr<flight> f) {
+        co_await pool.schedule();
+        try {
+            Value value = loader(key);
+            std::lock_guard<std::mutex> guard(lock);
+            cache.save(key, value);
+            f->value.emplace(std::move(value));
+            flights.remove(key);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(lock);
+            f->error = std::current_exception();
+            flights.remove(key);
+        }
+        // nobody joins a flight once it left flights
+        for (auto h : f->waiters) pool.post(h);
+    }
+};
+
+}  // namespace sjtu
+
+#endif
+
+#endif
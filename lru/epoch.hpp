@@ -0,0 +1,187 @@
+#ifndef SJTU_EPOCH_HPP
+#define SJTU_EPOCH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace sjtu {
+
+/**
+ * epoch based reclamation, shared by every structure whose readers
+ * take no lock.
+ * a reader holds an epoch_guard while it follows pointers. a writer
+ * unlinks an object first and hands it to retire() instead of freeing
+ * it: it is freed once the global epoch moved twice past the epoch it
+ * was retired in, as the epoch only moves when every reader inside a
+ * guard has seen the current one, no reader can still hold it then.
+ * readers never wait, a reader stuck in a guard only delays the frees.
+ * every thread keeps the objects it retired in a list of its own and
+ * sweeps it every collect_batch retires, or once the list doubled when
+ * a reader held the last sweep back, so writers share no lock.
+ */
+class epoch_domain {
+   public:
+    static epoch_domain &instance() {
+        static epoch_domain domain;
+        return domain;
+    }
+    epoch_domain(const epoch_domain &) = delete;
+    epoch_domain &operator=(const epoch_domain &) = delete;
+    ~epoch_domain() {
+        record *r = records.load();
+        while (r) {
+            for (auto &g : r->garbage) g.free(g.ptr);
+            record *next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    /**
+     * free p with free(p) once no reader can hold it any more,
+     * p must already be unreachable for new readers
+     */
+    void retire(void *p, void (*free)(void *)) {
+        record *r = local();
+        std::lock_guard<std::mutex> guard(r->lock);
+        r->garbage.push_back(retired{p, free, epoch.load()});
+        if (r->garbage.size() >= r->collect_at) {
+            advance();
+            sweep(*r);
+            r->collect_at = std::max(collect_batch, r->garbage.size() * 2);
+        }
+    }
+    /**
+     * try to move the epoch and free what is old enough in the lists
+     * of every thread, those of threads that ended too
+     */
+    void collect() {
+        advance();
+        for (record *r = records.load(); r; r = r->next) {
+            std::lock_guard<std::mutex> guard(r->lock);
+            sweep(*r);
+        }
+    }
+    /**
+     * objects retired but not freed yet
+     */
+    size_t pending() {
+        size_t n = 0;
+        for (record *r = records.load(); r; r = r->next) {
+            std::lock_guard<std::mutex> guard(r->lock);
+            n += r->garbage.size();
+        }
+        return n;
+    }
+
+   private:
+    friend class epoch_guard;
+    static constexpr size_t collect_batch = 64;
+
+    struct retired {
+        void *ptr;
+        void (*free)(void *);
+        unsigned long long epoch;
+    };
+    // one per thread, kept when the thread ends for the next one
+    struct alignas(64) record {
+        // 0 outside of a guard
+        std::atomic<unsigned long long> epoch{0};
+        std::atomic<bool> used{true};
+        unsigned depth = 0;
+        record *next = nullptr;
+        // only collect() and pending() contend with the owning thread
+        std::mutex lock;
+        std::vector<retired> garbage;
+        size_t collect_at = collect_batch;
+    };
+    // frees the record of a thread when it ends
+    struct owner {
+        record *r;
+        explicit owner(record *r) : r(r) {}
+        ~owner() { r->used.store(false); }
+    };
+
+    std::atomic<unsigned long long> epoch{1};
+    std::atomic<record *> records{nullptr};
+
+    epoch_domain() {}
+
+    record *local() {
+        static thread_local owner mine(acquire());
+        return mine.r;
+    }
+    record *acquire() {
+        for (record *r = records.load(); r; r = r->next) {
+            bool idle = false;
+            if (!r->used.load() && r->used.compare_exchange_strong(idle, true))
+                return r;
+        }
+        record *r = new record;
+        r->next = records.load();
+        while (!records.compare_exchange_weak(r->next, r)) {
+        }
+        return r;
+    }
+    void enter() {
+        record *r = local();
+        if (r->depth++ == 0) {
+            // publish an epoch that was still current once published,
+            // before any pointer is read
+            unsigned long long e = epoch.load();
+            r->epoch.store(e);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for (unsigned long long now; (now = epoch.load()) != e; e = now)
+                r->epoch.store(now);
+        }
+    }
+    void leave() {
+        record *r = local();
+        if (--r->depth == 0) r->epoch.store(0);
+    }
+    /**
+     * move the epoch on if every reader inside a guard has seen it,
+     * a thread that loses the race finds it moved by another
+     */
+    void advance() {
+        unsigned long long e = epoch.load();
+        for (record *r = records.load(); r; r = r->next) {
+            unsigned long long seen = r->epoch.load();
+            if (seen != 0 && seen != e) return;
+        }
+        epoch.compare_exchange_strong(e, e + 1);
+    }
+    /**
+     * free what r holds that is old enough, under the lock of r
+     */
+    void sweep(record &r) {
+        unsigned long long e = epoch.load();
+        size_t kept = 0;
+        for (auto &g : r.garbage) {
+            if (g.epoch + 2 <= e) {
+                g.free(g.ptr);
+            } else {
+                r.garbage[kept++] = g;
+            }
+        }
+        r.garbage.resize(kept);
+    }
+};
+
+/**
+ * the pointers read while a guard lives stay valid, guards nest
+ */
+class epoch_guard {
+   public:
+    epoch_guard() { epoch_domain::instance().enter(); }
+    ~epoch_guard() { epoch_domain::instance().leave(); }
+    epoch_guard(const epoch_guard &) = delete;
+    epoch_guard &operator=(const epoch_guard &) = delete;
+};
+
+}  // namespace sjtu
+
+#endif
@@ -1,27 +1,102 @@
 #ifndef SJTU_LRU_HPP
 #define SJTU_LRU_HPP
 
+#include "allocator.hpp"
 #include "class-integer.hpp"
 #include "class-matrix.hpp"
+#include "epoch.hpp"
 #include "exceptions.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// an int looks up the Integer of the same val, no Integer is built
 class Hash {
    public:
-    unsigned int operator()(Integer lhs) const {
-        int val = lhs.val;
-        return std::hash<int>()(val);
+    using is_transparent = void;
+    unsigned int operator()(const Integer &lhs) const {
+        return std::hash<int>()(lhs.val);
     }
+    unsigned int operator()(int val) const { return std::hash<int>()(val); }
 };
 class Equal {
    public:
+    using is_transparent = void;
     bool operator()(const Integer &lhs, const Integer &rhs) const {
         return lhs.val == rhs.val;
     }
+    bool operator()(const Integer &lhs, int rhs) const { return lhs.val == rhs; }
+    bool operator()(int lhs, const Integer &rhs) const { return lhs == rhs.val; }
 };
+inline std::ostream &operator<<(std::ostream &os, const Integer &x) {
+    return os << x.val;
+}
 
 namespace sjtu {
 
+/**
+ * lookups take any K instead of a Key when Hash and Equal both declare
+ * is_transparent, like the heterogeneous lookup of std::unordered_map:
+ * transparent_key<Hash, Equal, K> is K then, and no overload otherwise
+ */
+template <class Hash, class Equal, class = void>
+struct is_transparent_lookup : std::false_type {};
+template <class Hash, class Equal>
+struct is_transparent_lookup<Hash, Equal,
+                             std::void_t<typename Hash::is_transparent,
+                                         typename Equal::is_transparent> >
+    : std::true_type {};
+template <class Hash, class Equal, class K>
+using transparent_key =
+    std::enable_if_t<is_transparent_lookup<Hash, Equal>::value, K>;
+
+/**
+ * ask for the cache line of p ahead of its use, p may be nullptr
+ */
+inline void prefetch(const void *p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+/**
+ * a range whose length is known before it is walked
+ */
+template <class It, class = void>
+struct is_forward_iterator : std::false_type {};
+template <class It>
+struct is_forward_iterator<
+    It, std::void_t<typename std::iterator_traits<It>::iterator_category> >
+    : std::is_base_of<std::forward_iterator_tag,
+                      typename std::iterator_traits<It>::iterator_category> {};
+/**
+ * an allocator that can set n objects aside in one block,
+ * like pool_allocator
+ */
+template <class A, class = void>
+struct has_reserve : std::false_type {};
+template <class A>
+struct has_reserve<A, std::void_t<decltype(std::declval<A &>().reserve(
+                          std::declval<size_t>()))> > : std::true_type {};
+
 template <class T>
 class Node {
    public:
@@ -29,20 +104,50 @@ class Node {
     Node *prev;
     Node *next;
     Node(const T &val) : data(val), prev(nullptr), next(nullptr) {}
+    /**
+     * build data in place from the argument tuples of its members
+     */
+    template <class... Args>
+    Node(std::piecewise_construct_t pc, Args &&...args)
+        : data(pc, std::forward<Args>(args)...), prev(nullptr), next(nullptr) {}
 };
 
-template <class T>
+template <class T, class Alloc = std::allocator<T> >
 class double_list {
    private:
+    using node_allocator =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Node<T> >;
+    using node_traits = std::allocator_traits<node_allocator>;
+
     Node<T> *head;
     Node<T> *tail;
+    node_allocator alloc;
+
+    Node<T> *new_node(const T &val) {
+        Node<T> *p = node_traits::allocate(alloc, 1);
+        try {
+            node_traits::construct(alloc, p, val);
+        } catch (...) {
+            node_traits::deallocate(alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+    void delete_node(Node<T> *p) {
+        node_traits::destroy(alloc, p);
+        node_traits::deallocate(alloc, p, 1);
+    }
 
    public:
     double_list() {
         head = nullptr;
         tail = nullptr;
     }
-    double_list(const double_list<T> &other) : head(nullptr), tail(nullptr) {
+    double_list(const double_list &other)
+        : head(nullptr),
+          tail(nullptr),
+          alloc(node_traits::select_on_container_copy_construction(
+              other.alloc)) {
         Node<T> *tmp = other.head;
         while (tmp) {
             insert_tail(tmp->data);
@@ -206,20 +311,9 @@ class double_list {
             return pos;
         }
         Node<T> *tmp = pos.cur;
-        if (tmp->prev) {
-            tmp->prev->next = tmp->next;
-        }
-        if (tmp->next) {
-            tmp->next->prev = tmp->prev;
-        }
-        if (tmp == head) {
-            head = tmp->next;
-        }
-        if (tmp == tail) {
-            tail = tmp->prev;
-        }
         iterator newIter(tmp->next);
-        delete tmp;
+        unlink(tmp);
+        delete_node(tmp);
         return newIter;
     }
     iterator get_tail() const{
@@ -229,7 +323,7 @@ class double_list {
      * the following are operations of double list
      */
     void insert_head(const T &val) {
-        Node<T> *newNode = new Node<T>(val);
+        Node<T> *newNode = new_node(val);
         if (head == nullptr) {
             head = newNode;
             tail = newNode;
@@ -240,7 +334,7 @@ class double_list {
         }
     }
     void insert_tail(const T &val) {
-        Node<T> *newNode = new Node<T>(val);
+        Node<T> *newNode = new_node(val);
         if (tail == nullptr) {
             head = tail = newNode;
         } else {
@@ -249,19 +343,145 @@ class double_list {
             tail = newNode;
         }
     }
+    /**
+     * link and unlink nodes owned by someone else,
+     * e.g. linked_hashmap whose nodes are allocated by hashmap,
+     * these never allocate or free a node
+     */
+    /**
+     * link first..last, already chained by prev and next, at the tail
+     */
+    void link_tail(Node<T> *first, Node<T> *last) {
+        first->prev = tail;
+        last->next = nullptr;
+        if (tail == nullptr) {
+            head = first;
+        } else {
+            tail->next = first;
+        }
+        tail = last;
+    }
+    void link_tail(Node<T> *node) {
+        node->next = nullptr;
+        node->prev = tail;
+        if (tail == nullptr) {
+            head = tail = node;
+        } else {
+            tail->next = node;
+            tail = node;
+        }
+    }
+    void link_head(Node<T> *node) {
+        node->prev = nullptr;
+        node->next = head;
+        if (head == nullptr) {
+            head = tail = node;
+        } else {
+            head->prev = node;
+            head = node;
+        }
+    }
+    /**
+     * link node in front of pos, at the tail if pos is nullptr
+     */
+    void link_before(Node<T> *pos, Node<T> *node) {
+        if (pos == nullptr) {
+            link_tail(node);
+            return;
+        }
+        node->next = pos;
+        node->prev = pos->prev;
+        if (pos->prev)
+            pos->prev->next = node;
+        else
+            head = node;
+        pos->prev = node;
+    }
+    void unlink(Node<T> *node) {
+        if (node->prev) {
+            node->prev->next = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        }
+        if (node == head) {
+            head = node->next;
+        }
+        if (node == tail) {
+            tail = node->prev;
+        }
+        node->prev = node->next = nullptr;
+    }
+    /**
+     * forget every node without freeing them
+     */
+    void release() { head = tail = nullptr; }
+    /**
+     * relink the element pointed by pos to the tail (head) of the list,
+     * O(1), no node is allocated or copied and every iterator stays valid
+     * if pos points to nothing, do nothing
+     */
+    void move_to_tail(iterator pos) {
+        if (pos.cur == nullptr || pos.cur == tail) return;
+        unlink(pos.cur);
+        link_tail(pos.cur);
+    }
+    void move_to_head(iterator pos) {
+        if (pos.cur == nullptr || pos.cur == head) return;
+        unlink(pos.cur);
+        link_head(pos.cur);
+    }
+    /**
+     * move the element pointed by it out of other and in front of pos,
+     * pos == end() appends it. other may be this list itself.
+     * the node changes owner, so both lists must free nodes the same way:
+     * equal allocators, or lists that own nothing like the order list of
+     * linked_hashmap
+     */
+    void splice(iterator pos, double_list &other, iterator it) {
+        if (it.cur == nullptr || it.cur == pos.cur) return;
+        other.unlink(it.cur);
+        link_before(pos.cur, it.cur);
+    }
+    /**
+     * move every element of other in front of pos, other becomes empty
+     */
+    void splice(iterator pos, double_list &other) {
+        if (&other == this || other.head == nullptr) return;
+        Node<T> *first = other.head, *last = other.tail;
+        other.head = other.tail = nullptr;
+        Node<T> *next = pos.cur;
+        Node<T> *prev = next ? next->prev : tail;
+        first->prev = prev;
+        last->next = next;
+        if (prev)
+            prev->next = first;
+        else
+            head = first;
+        if (next)
+            next->prev = last;
+        else
+            tail = last;
+    }
     void delete_head() {
         if (!head) return;
         Node<T> *tmp = head;
         head = head->next;
-        if (head) head->prev = nullptr;
-        delete tmp;
+        if (head)
+            head->prev = nullptr;
+        else
+            tail = nullptr;
+        delete_node(tmp);
     }
     void delete_tail() {
         if (!tail) return;
         Node<T> *tmp = tail;
         tail = tail->prev;
-        if (tail) tail->next = nullptr;
-        delete tmp;
+        if (tail)
+            tail->next = nullptr;
+        else
+            head = nullptr;
+        delete_node(tmp);
     }
     /**
      * if didn't contain anything, return true,
@@ -285,104 +505,335 @@ class double_list {
         Node<T> *tmp = head;
         while (tmp) {
             Node<T> *next = tmp->next;
-            delete tmp;
+            delete_node(tmp);
             tmp = next;
         }
         head = tail = nullptr;
     }
 };
 
-template <class Key, class T, class Hash = std::hash<Key>,
-          class Equal = std::equal_to<Key> >
-class hashmap {
+/**
+ * whether hashmap keeps the full hash of the key in every node.
+ * then a resize never calls Hash again and a lookup only calls Equal
+ * on nodes whose hash matches. it is on unless Hash is as cheap as
+ * reading the stored value, specialize it to choose for your Hash.
+ */
+template <class Hash>
+struct cache_hash : std::true_type {};
+template <class K>
+struct cache_hash<std::hash<K> >
+    : std::integral_constant<bool, !std::is_scalar<K>::value> {};
+template <>
+struct cache_hash< ::Hash> : std::false_type {};
+
+/**
+ * the stored hash of a node, empty when it is not cached
+ */
+template <bool Cached>
+class stored_hash {
+   public:
+    void store(size_t) {}
+    bool may_equal(size_t) const { return true; }
+};
+template <>
+class stored_hash<true> {
+   public:
+    size_t hash_code;
+    void store(size_t h) { hash_code = h; }
+    bool may_equal(size_t h) const { return hash_code == h; }
+};
+
+/**
+ * node of the chained hashmap
+ * chain links the bucket, prev/next are the order links used when
+ * the node also sits in the double_list of a linked_hashmap,
+ * so every entry is allocated and stored only once
+ */
+template <class T, bool Cached = false>
+class hash_node : public Node<T>, public stored_hash<Cached> {
+   public:
+    hash_node *chain;
+    hash_node(const T &val) : Node<T>(val), chain(nullptr) {}
+    template <class... Args>
+    hash_node(std::piecewise_construct_t pc, Args &&...args)
+        : Node<T>(pc, std::forward<Args>(args)...), chain(nullptr) {}
+};
+
+/**
+ * node of the swiss hashmap: no bucket chain to keep, the order links
+ * and maybe the hash
+ */
+template <class T, bool Cached = false>
+class swiss_node : public Node<T>, public stored_hash<Cached> {
+   public:
+    swiss_node(const T &val) : Node<T>(val) {}
+    template <class... Args>
+    swiss_node(std::piecewise_construct_t pc, Args &&...args)
+        : Node<T>(pc, std::forward<Args>(args)...) {}
+};
+
+/**
+ * the allocator of the nodes of a hashmap table, and building and
+ * freeing a node with it. a copy gets the allocator
+ * select_on_container_copy_construction gives, assigning a table
+ * keeps its own
+ */
+template <class NodeType, class Alloc>
+class node_owner {
+   public:
+    using node_allocator =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<NodeType>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+    node_allocator alloc;
+
+    /**
+     * the allocator the nodes come from
+     */
+    const node_allocator &get_allocator() const { return alloc; }
+
+   protected:
+    node_owner() {}
+    node_owner(const node_owner &other)
+        : alloc(node_traits::select_on_container_copy_construction(
+              other.alloc)) {}
+    node_owner &operator=(const node_owner &) { return *this; }
+
+    template <class... Args>
+    NodeType *new_node(Args &&...args) {
+        NodeType *p = node_traits::allocate(alloc, 1);
+        try {
+            node_traits::construct(alloc, p, std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+    void delete_node(NodeType *p) {
+        node_traits::destroy(alloc, p);
+        node_traits::deallocate(alloc, p, 1);
+    }
+};
+
+/**
+ * storage engines of hashmap, selected by its last template parameter
+ * chained_storage: separate chaining, every bucket is a list of nodes
+ * incremental_storage: chained, but a resize keeps the old bucket array
+ *   and moves a few buckets per insert/find/remove instead of all at once.
+ *   every non-const lookup moves some (find, find_many, at, operator[],
+ *   touch), a const one only reads, so that const readers may share the
+ *   map: a map only read through const calls finishes the move with
+ *   rehash_step() or rehash()
+ * swiss_storage: open addressing, a control byte array holding 7-bit
+ *   hash tags in front of a flat slot array, probed 16 slots at a time
+ */
+struct chained_storage {};
+struct incremental_storage {};
+struct swiss_storage {};
+
+/**
+ * bucket index policies of the chained hashmap, its sixth template
+ * parameter. a policy is told the bucket count by reset() whenever it
+ * changes and maps a hash value to a bucket with operator().
+ * size(n) is the bucket count actually used when n are asked for.
+ *
+ * mod_index: h % n, a division on every lookup
+ * fibonacci_index: power-of-two n, the top bits of h * 2^64/phi
+ * murmur_index: power-of-two n, the murmur3 finalizer of h, masked
+ * prime_index: prime n, h mod n by a precomputed multiply (fastmod)
+ *
+ * both power-of-two policies mix the hash first, so an identity hash
+ * such as std::hash<int> does not pile strided keys into one bucket.
+ * prime_index is the default: it keeps sequential keys in sequential
+ * buckets, spreads strided ones, and costs two multiplies.
+ */
+class mod_index {
+    size_t n = 1;
+
+   public:
+    static size_t size(size_t cnt) { return cnt; }
+    void reset(size_t cnt) { n = cnt; }
+    size_t operator()(size_t h) const { return h % n; }
+};
+
+class fibonacci_index {
+    int shift = 63;
+
+   public:
+    static size_t size(size_t cnt) {
+        size_t n = 1;
+        while (n < cnt) n <<= 1;
+        return n;
+    }
+    void reset(size_t cnt) {
+        shift = 64;
+        while (cnt > 1) {
+            cnt >>= 1;
+            --shift;
+        }
+    }
+    size_t operator()(size_t h) const {
+        return static_cast<size_t>(
+            (static_cast<unsigned long long>(h) * 0x9e3779b97f4a7c15ULL) >>
+            shift);
+    }
+};
+
+class murmur_index {
+    size_t mask = 0;
+
+   public:
+    static size_t size(size_t cnt) { return fibonacci_index::size(cnt); }
+    void reset(size_t cnt) { mask = cnt - 1; }
+    /**
+     * murmur3 fmix64, every input bit reaches every output bit
+     */
+    static size_t mix(size_t h) {
+        unsigned long long x = h;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+    size_t operator()(size_t h) const { return mix(h) & mask; }
+};
+
+class prime_index {
+    unsigned n = 1;
+    unsigned long long magic = 0;
+
+   public:
+    /**
+     * roughly doubling primes, the last one fits in 32 bits
+     */
+    static size_t size(size_t cnt) {
+        static const unsigned primes[] = {
+            17u,        37u,        79u,         163u,       331u,
+            673u,       1361u,      2729u,       5471u,      10949u,
+            21911u,     43853u,     87719u,      175447u,    350899u,
+            701819u,    1403641u,   2807303u,    5614657u,   11229331u,
+            22458671u,  44917381u,  89834777u,   179669557u, 359339171u,
+            718678369u, 1437356741u, 2874713497u, 4294967291u};
+        for (unsigned p : primes) {
+            if (p >= cnt) return p;
+        }
+        return primes[sizeof(primes) / sizeof(primes[0]) - 1];
+    }
+    void reset(size_t cnt) {
+        n = static_cast<unsigned>(cnt);
+        magic = ~0ULL / n + 1;
+    }
+    size_t operator()(size_t h) const {
+        unsigned long long x = h;
+        unsigned a = static_cast<unsigned>(x ^ (x >> 32));
+#if defined(__SIZEOF_INT128__)
+        // Lemire's fastmod: the low 64 bits of magic * a are the
+        // fraction a / n, multiplying back by n gives the remainder
+        unsigned long long frac = magic * a;
+        return static_cast<size_t>(
+            (static_cast<unsigned __int128>(frac) * n) >> 64);
+#else
+        return a % n;
+#endif
+    }
+};
+
+/**
+ * the storages of hashmap, what finding a key and making room for one
+ * depends on. hashmap adds the insertion and lookup interface on top.
+ * the primary template is the chained table of chained_storage and
+ * incremental_storage
+ */
+template <class Key, class T, class Hash, class Equal, class Storage,
+          class Index, class Alloc>
+class hashmap_table
+    : public node_owner<
+          hash_node<pair<const Key, T>, cache_hash<Hash>::value>, Alloc> {
    public:
     using value_type = pair<const Key, T>;
 
-    struct Node {
-        value_type data;
-        Node *next;
-        typename double_list<value_type>::iterator list_iter;
-        Node(const value_type &other) : data(other), next(nullptr) {}
-    };
+    static constexpr bool cached = cache_hash<Hash>::value;
+    using Node = hash_node<value_type, cached>;
+    using bucket_array = std::vector<Node *, zeroed_allocator<Node *> >;
+    using owner = node_owner<Node, Alloc>;
+    using typename owner::node_allocator;
+    using typename owner::node_traits;
+    using owner::alloc;
 
-    std::vector<Node *> buckets;
+    bucket_array buckets;
     Hash hash;
     Equal equal;
+    Index index;
     size_t num_elem;
-    static const size_t init_cnt = 16;
+    float max_load;
+    static constexpr size_t init_cnt = 16;
     /**
-     * elements
-     * add whatever you want
+     * incremental_storage only: the bucket array being drained,
+     * buckets before migrate_pos have already been moved to buckets
      */
+    bucket_array old_buckets;
+    Index old_index;
+    size_t migrate_pos;
+    static constexpr bool incremental =
+        std::is_same<Storage, incremental_storage>::value;
+    static const size_t migrate_batch = 4;
+    static constexpr size_t lookup_batch = 32;
 
     /**
      * the follows are constructors and destructors
      * you can also add some if needed.
      */
-    hashmap() : buckets(init_cnt, nullptr), num_elem(0) {}
-    hashmap(const hashmap &other)
-        : buckets(other.buckets.size(), nullptr),
-          num_elem(other.num_elem),
+    hashmap_table()
+        : buckets(Index::size(init_cnt), nullptr),
+          num_elem(0),
+          max_load(0.75f),
+          migrate_pos(0) {
+        index.reset(buckets.size());
+    }
+    hashmap_table(const hashmap_table &other)
+        : owner(other),
+          buckets(other.buckets.size(), nullptr),
           hash(other.hash),
-          equal(other.equal) {
-        for (int i = 0; i < other.buckets.size(); ++i) {
-            if (other.buckets[i]) {
-                Node *src = other.buckets[i];
-                Node *new_head = new Node(src->data);
-                buckets[i] = new_head;
-                src = src->next;
-                Node *tail = new_head;
-                while (src) {
-                    tail->next = new Node(src->data);
-                    tail = tail->next;
-                    src = src->next;
-                }
-            }
-        }
+          equal(other.equal),
+          index(other.index),
+          num_elem(other.num_elem),
+          max_load(other.max_load),
+          old_buckets(other.old_buckets.size(), nullptr),
+          old_index(other.old_index),
+          migrate_pos(other.migrate_pos) {
+        copy_buckets(buckets, other.buckets);
+        copy_buckets(old_buckets, other.old_buckets);
     }
-    ~hashmap() {
-        int s = buckets.size();
-        for (int i = 0; i < s; ++i) {
-            if (buckets[i]) {
-                Node *src = buckets[i];
-                while (src) {
-                    Node *tmp = src->next;
-                    delete src;
-                    src = tmp;
-                }
-            }
-        }
+    ~hashmap_table() {
+        free_buckets(buckets);
+        free_buckets(old_buckets);
     }
-    hashmap &operator=(const hashmap &other) {
+    hashmap_table &operator=(const hashmap_table &other) {
         if (this != &other) {
             clear();
         } else {
             return *this;
         }
-        buckets.resize(other.buckets.size(), nullptr);
+        buckets.assign(other.buckets.size(), nullptr);
+        old_buckets.assign(other.old_buckets.size(), nullptr);
+        migrate_pos = other.migrate_pos;
         num_elem = other.num_elem;
+        max_load = other.max_load;
         hash = other.hash;
         equal = other.equal;
-        for (int i = 0; i < other.buckets.size(); ++i) {
-            if (other.buckets[i]) {
-                Node *src = other.buckets[i];
-                Node *new_head = new Node(src->data);
-                buckets[i] = new_head;
-                src = src->next;
-                Node *tail = new_head;
-                while (src) {
-                    tail->next = new Node(src->data);
-                    tail = tail->next;
-                    src = src->next;
-                }
-            }
-        }
+        index = other.index;
+        old_index = other.old_index;
+        copy_buckets(buckets, other.buckets);
+        copy_buckets(old_buckets, other.old_buckets);
         return *this;
     }
 
     class iterator {
        private:
-        const hashmap *map;
+        const hashmap_table *map;
         int bucket_index;
         Node *cur;
 
@@ -400,7 +851,7 @@ class hashmap {
         iterator() : map(nullptr), bucket_index(0), cur(nullptr) {}
         iterator(const iterator &t)
             : map(t.map), bucket_index(t.bucket_index), cur(t.cur) {}
-        iterator(const hashmap *m, int idx, Node *node)
+        iterator(const hashmap_table *m, int idx, Node *node)
             : map(m), bucket_index(idx), cur(node) {
             if (!cur && map) {
                 int s = map->buckets.size();
@@ -439,38 +890,95 @@ class hashmap {
         bool operator!=(const iterator &rhs) const { return cur != rhs.cur; }
     };
 
+    size_t size() const { return num_elem; }
+
     void clear() {
-        int s = buckets.size();
-        for (int i = 0; i < s; ++i) {
-            if (buckets[i]) {
-                Node *src = buckets[i];
-                while (src) {
-                    Node *tmp = src->next;
-                    delete src;
-                    src = tmp;
-                }
-                buckets[i] = nullptr;
-            }
-        }
+        free_buckets(buckets);
+        free_buckets(old_buckets);
+        bucket_array().swap(old_buckets);
+        migrate_pos = 0;
         num_elem = 0;
     }
     /**
      * you need to expand the hashmap dynamically
+     * incremental_storage only allocates the new bucket array here,
+     * the nodes are moved later by rehash_step
      */
     void expand() {
-        std::vector<Node *> new_buckets(buckets.size() * 2, nullptr);
-        int s = buckets.size();
-        for (int i = 0; i < s; ++i) {
-            Node *cur = buckets[i];
+        if (incremental) {
+            while (!old_buckets.empty()) rehash_step();
+            bucket_array new_buckets(Index::size(buckets.size() * 2));
+            old_buckets.swap(buckets);
+            buckets.swap(new_buckets);
+            old_index = index;
+            index.reset(buckets.size());
+            migrate_pos = 0;
+            return;
+        }
+        relink(Index::size(buckets.size() * 2));
+    }
+    size_t bucket_count() const { return buckets.size(); }
+    float load_factor() const {
+        return static_cast<float>(num_elem) / buckets.size();
+    }
+    float max_load_factor() const { return max_load; }
+    /**
+     * the table grows once size() / bucket_count() passes ml,
+     * 0.75 by default. a table already past it grows at once.
+     * throw if ml is not positive
+     */
+    void max_load_factor(float ml) {
+        if (!(ml > 0)) throw "invalid";
+        max_load = ml;
+        if (num_elem > buckets.size() * max_load) rehash(bucket_count());
+    }
+    /**
+     * rebuild the table with at least cnt buckets, and never fewer than
+     * size() needs under max_load_factor() or init_cnt: rehash(0) gives
+     * back the buckets left over after many removals.
+     * unlike expand, it is done at once for incremental_storage too.
+     * iterators are invalidated, nodes do not move
+     */
+    void rehash(size_t cnt) {
+        size_t need = static_cast<size_t>(std::ceil(num_elem / max_load));
+        cnt = std::max(cnt, std::max(need, init_cnt));
+        while (!old_buckets.empty()) rehash_step();
+        if (Index::size(cnt) != buckets.size()) relink(Index::size(cnt));
+    }
+    /**
+     * make room for n elements without growing again
+     */
+    void reserve(size_t n) {
+        rehash(static_cast<size_t>(std::ceil(n / max_load)));
+    }
+    /**
+     * the fewest buckets that hold size() elements
+     */
+    void shrink_to_fit() { rehash(0); }
+    /**
+     * move at most migrate_batch buckets of old_buckets,
+     * the new array has twice the buckets so it has to absorb
+     * more than one old bucket per insert to finish in time
+     */
+    void rehash_step() {
+        if (!incremental || old_buckets.empty()) return;
+        size_t s = old_buckets.size();
+        size_t stop = std::min(s, migrate_pos + migrate_batch);
+        for (; migrate_pos < stop; ++migrate_pos) {
+            Node *cur = old_buckets[migrate_pos];
             while (cur) {
-                Node *tmp = cur->next;
-                int new_idx = hash(cur->data.first) % (2 * s);
-                cur->next = new_buckets[new_idx];
-                new_buckets[new_idx] = cur;
+                Node *tmp = cur->chain;
+                size_t new_idx = index(node_hash(cur));
+                cur->chain = buckets[new_idx];
+                buckets[new_idx] = cur;
                 cur = tmp;
             }
+            old_buckets[migrate_pos] = nullptr;
+        }
+        if (migrate_pos == s) {
+            bucket_array().swap(old_buckets);
+            migrate_pos = 0;
         }
-        buckets = new_buckets;
     }
 
     /**
@@ -478,476 +986,3428 @@ class hashmap {
      */
     iterator end() const { return iterator(this, buckets.size(), nullptr); }
     /**
-     * find, return a pointer point to the value
-     * not find, return the end (point to nothing)
+     * the head of the chain holding hash value h, in old_buckets
+     * if that bucket has not been moved yet
+     * idx is set to the bucket in the array holding it
+     */
+    Node *const *bucket_of(size_t h, int &idx) const {
+        if (incremental && !old_buckets.empty()) {
+            size_t old_idx = old_index(h);
+            if (old_idx >= migrate_pos) {
+                idx = old_idx;
+                return &old_buckets[old_idx];
+            }
+        }
+        idx = index(h);
+        return &buckets[idx];
+    }
+    Node **bucket_of(size_t h, int &idx) {
+        const hashmap_table *self = this;
+        return const_cast<Node **>(self->bucket_of(h, idx));
+    }
+    /**
+     * the node holding key, nullptr if not found
+     * idx is set to the bucket of the key
+     * shared by hashmap and linked_hashmap. it does not move any
+     * buckets of incremental_storage, the non-const callers step first
      */
-    iterator find(const Key &key) const {
-        int idx = hash(key) % buckets.size();
-        Node *src = buckets[idx];
+    template <class K>
+    Node *find_node(const K &key, int &idx) const {
+        size_t h = hash(key);
+        Node *src = *bucket_of(h, idx);
         while (src) {
-            if (equal(src->data.first, key)) return iterator(this, idx, src);
-            src = src->next;
+            if (src->may_equal(h) && equal(src->data.first, key)) return src;
+            src = src->chain;
         }
-        return iterator(this, buckets.size(), nullptr);
+        return nullptr;
+    }
+    template <class K>
+    Node *find_node(const K &key) const {
+        int idx;
+        return find_node(key, idx);
     }
     /**
-     * already have a value_pair with the same key
-     * -> just update the value, return false
-     * not find a value_pair with the same key
-     * -> insert the value_pair, return true
+     * return the node holding key, inserted is set to false if it
+     * existed and nothing changed. otherwise a node is built in place
+     * from key and args (the constructor arguments of the value)
      */
-    sjtu::pair<iterator, bool> insert(const value_type &value_pair) {
-        Key key = value_pair.first;
-        int idx = hash(key) % buckets.size();
-        Node *cur = buckets[idx];
-        bool flag = true;
+    template <class K, class... Args>
+    Node *try_emplace_node(K &&key, bool &inserted, int &idx,
+                           Args &&...args) {
+        rehash_step();
+        size_t h = hash(key);
+        Node **head = bucket_of(h, idx);
+        Node *cur = *head;
         while (cur) {
-            if (equal(key, cur->data.first)) {
-                flag = false;
-                cur->data.second = value_pair.second;
-                auto it = iterator(this, idx, cur);
-                return sjtu::pair<iterator, bool>(it, flag);
-            } else {
-                cur = cur->next;
+            if (cur->may_equal(h) && equal(key, cur->data.first)) {
+                inserted = false;
+                return cur;
             }
+            cur = cur->chain;
         }
-        Node *newnode = new Node(value_pair);
-        newnode->next = buckets[idx];
-        buckets[idx] = newnode;
+        inserted = true;
+        Node *newnode = new_node(
+            std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        newnode->store(h);
+        newnode->chain = *head;
+        *head = newnode;
         num_elem++;
-        if (num_elem > buckets.size() * 0.75) {
+        if (num_elem > buckets.size() * max_load) {
             expand();
+            bucket_of(h, idx);
         }
-        auto it = iterator(this, idx, newnode);
-        return sjtu::pair<iterator, bool>(it, flag);
+        return newnode;
     }
     /**
-     * the value_pair exists, remove and return true
-     * otherwise, return false
+     * take the node of key out of the map without freeing it,
+     * nullptr if not found. the caller ends it with destroy_node,
+     * which does not touch the map and may run anywhere, then
+     * deallocate_node
      */
-    bool remove(const Key &key) {
-        int idx = hash(key) % buckets.size();
-        Node *src = buckets[idx];
-        if (!src) return false;
-        if (equal(src->data.first, key)) {
-            buckets[idx] = buckets[idx]->next;
-            delete src;
-            num_elem--;
-            return true;
+    template <class K>
+    Node *extract_node(const K &key) {
+        rehash_step();
+        int idx;
+        size_t h = hash(key);
+        Node **link = bucket_of(h, idx);
+        while (*link) {
+            Node *cur = *link;
+            if (cur->may_equal(h) && equal(cur->data.first, key)) {
+                *link = cur->chain;
+                num_elem--;
+                return cur;
+            }
+            link = &cur->chain;
         }
+        return nullptr;
+    }
+    /**
+     * the same for a node known to be in the map: its bucket comes from
+     * the hash of the node and is walked by address, no key is compared
+     */
+    void unlink_node(Node *node) {
+        rehash_step();
+        int idx;
+        Node **link = bucket_of(node_hash(node), idx);
+        while (*link != node) link = &(*link)->chain;
+        *link = node->chain;
+        num_elem--;
+    }
+    void destroy_node(Node *p) { node_traits::destroy(alloc, p); }
+    void deallocate_node(Node *p) { node_traits::deallocate(alloc, p, 1); }
 
-        Node *cur = src->next;
-        while (cur) {
-            if (equal(cur->data.first, key)) {
-                src->next = cur->next;
-                delete cur;
-                num_elem--;
-                return true;
+   protected:
+    using owner::new_node;
+    using owner::delete_node;
+
+    /**
+     * find_node for m <= lookup_batch keys, in three passes: every hash
+     * first, then the bucket heads of all of them are prefetched, then
+     * their first nodes, and the keys are compared last
+     */
+    template <class K>
+    void find_batch(const K *keys, size_t m, Node **out, int *idx) const {
+        size_t h[lookup_batch];
+        Node *const *head[lookup_batch];
+        for (size_t i = 0; i < m; ++i) {
+            h[i] = hash(keys[i]);
+            head[i] = bucket_of(h[i], idx[i]);
+            prefetch(head[i]);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            out[i] = *head[i];
+            if (out[i]) prefetch(out[i]);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            Node *src = out[i];
+            while (src && !(src->may_equal(h[i]) &&
+                            equal(src->data.first, keys[i]))) {
+                src = src->chain;
             }
-            src = cur;
-            cur = cur->next;
+            out[i] = src;
+        }
+    }
+    template <class K>
+    bool remove_key(const K &key) {
+        Node *cur = extract_node(key);
+        if (!cur) return false;
+        delete_node(cur);
+        return true;
+    }
+    /**
+     * move every node into a new array of cnt buckets
+     */
+    void relink(size_t cnt) {
+        bucket_array new_buckets(cnt);
+        Index new_index;
+        new_index.reset(new_buckets.size());
+        int s = buckets.size();
+        for (int i = 0; i < s; ++i) {
+            Node *cur = buckets[i];
+            while (cur) {
+                Node *tmp = cur->chain;
+                size_t new_idx = new_index(node_hash(cur));
+                cur->chain = new_buckets[new_idx];
+                new_buckets[new_idx] = cur;
+                cur = tmp;
+            }
+        }
+        buckets.swap(new_buckets);
+        index = new_index;
+    }
+    /**
+     * the hash of the key in node, without calling Hash when cached
+     */
+    size_t node_hash(const Node *node) const {
+        if constexpr (cached) {
+            return node->hash_code;
+        } else {
+            return hash(node->data.first);
+        }
+    }
+    void copy_buckets(bucket_array &dst, const bucket_array &src) {
+        for (size_t i = 0; i < src.size(); ++i) {
+            Node **tail = &dst[i];
+            for (Node *cur = src[i]; cur; cur = cur->chain) {
+                *tail = new_node(cur->data);
+                static_cast<stored_hash<cached> &>(**tail) = *cur;
+                tail = &(*tail)->chain;
+            }
+        }
+    }
+    void free_buckets(bucket_array &dst) {
+        for (size_t i = 0; i < dst.size(); ++i) {
+            Node *src = dst[i];
+            while (src) {
+                Node *tmp = src->chain;
+                delete_node(src);
+                src = tmp;
+            }
+            dst[i] = nullptr;
         }
-        return false;
     }
 };
 
-template <class Key, class T, class Hash = std::hash<Key>,
-          class Equal = std::equal_to<Key> >
-class linked_hashmap : public hashmap<Key, T, Hash, Equal> {
+/**
+ * hashmap on swiss_storage
+ * ctrl[i] is ctrl_empty, ctrl_deleted or the low 7 bits (h2) of the
+ * hash of the key living in slots[i]. the table is split into groups
+ * of 16 slots and a probe compares a whole group of tags at once, so a
+ * node is only dereferenced when its tag matches.
+ * slots hold node pointers: nodes never move on rehash, which keeps the
+ * order links of linked_hashmap and the pointers handed out by lru valid.
+ * the tag and the group both come from murmur_index::mix of the hash,
+ * the tags need well mixed low bits, so the Index policy is not used.
+ */
+template <class Key, class T, class Hash, class Equal, class Index,
+          class Alloc>
+class hashmap_table<Key, T, Hash, Equal, swiss_storage, Index, Alloc>
+    : public node_owner<
+          swiss_node<pair<const Key, T>, cache_hash<Hash>::value>, Alloc> {
    public:
-    typedef pair<const Key, T> value_type;
-    using Node = typename hashmap<Key, T, Hash, Equal>::Node;
-    double_list<value_type> db;
+    using value_type = pair<const Key, T>;
 
-    class const_iterator;
+    static constexpr bool cached = cache_hash<Hash>::value;
+    using Node = swiss_node<value_type, cached>;
+    using owner = node_owner<Node, Alloc>;
+    using typename owner::node_allocator;
+    using typename owner::node_traits;
+    using owner::alloc;
+
+    static constexpr size_t group_width = 16;
+    static constexpr signed char ctrl_empty = -128;
+    static constexpr signed char ctrl_deleted = -2;
+
+    std::vector<signed char> ctrl;
+    std::vector<Node *> slots;
+    Hash hash;
+    Equal equal;
+    size_t num_elem;
+    size_t num_deleted;
+    // of the live and deleted slots together, at most 7/8
+    float max_load;
+    static constexpr size_t init_cnt = 16;
+    static constexpr size_t lookup_batch = 32;
+
+    hashmap_table()
+        : ctrl(init_cnt, ctrl_empty),
+          slots(init_cnt, nullptr),
+          num_elem(0),
+          num_deleted(0),
+          max_load(0.875f) {}
+    hashmap_table(const hashmap_table &other)
+        : owner(other),
+          ctrl(other.ctrl),
+          slots(other.slots.size(), nullptr),
+          hash(other.hash),
+          equal(other.equal),
+          num_elem(other.num_elem),
+          num_deleted(other.num_deleted),
+          max_load(other.max_load) {
+        copy_slots(other);
+    }
+    ~hashmap_table() { free_slots(); }
+    hashmap_table &operator=(const hashmap_table &other) {
+        if (this == &other) return *this;
+        free_slots();
+        ctrl = other.ctrl;
+        slots.assign(other.slots.size(), nullptr);
+        hash = other.hash;
+        equal = other.equal;
+        num_elem = other.num_elem;
+        num_deleted = other.num_deleted;
+        max_load = other.max_load;
+        copy_slots(other);
+        return *this;
+    }
 
     class iterator {
+       private:
+        const hashmap_table *map;
+        int slot_index;
+        Node *cur;
+
        public:
-        typename double_list<value_type>::iterator list_iter;
-        /**
-         * elements
-         * add whatever you want
-         */
-        // --------------------------
-        iterator() {}
-        iterator(const typename double_list<value_type>::iterator &it)
-            : list_iter(it) {}
-        iterator(const iterator &other) : list_iter(other.list_iter) {}
+        iterator() : map(nullptr), slot_index(0), cur(nullptr) {}
+        iterator(const iterator &t)
+            : map(t.map), slot_index(t.slot_index), cur(t.cur) {}
+        iterator(const hashmap_table *m, int idx, Node *node)
+            : map(m), slot_index(idx), cur(node) {
+            if (!cur && map) {
+                int s = map->slots.size();
+                while (slot_index < s && map->ctrl[slot_index] < 0) {
+                    ++slot_index;
+                }
+                if (slot_index < s)
+                    cur = map->slots[slot_index];
+                else
+                    cur = nullptr;
+            }
+        }
         ~iterator() {}
 
-        /**
-         * iter++
-         */
-        iterator operator++(int) { 
-            iterator tmp = *this;
+        value_type &operator*() const {
+            if (!cur) {
+                throw "invalid";
+            } else
+                return cur->data;
+        }
+        value_type *operator->() const noexcept {
+            if (!cur) {
+                throw "invalid";
+            } else
+                return &cur->data;
+        }
+        bool operator==(const iterator &rhs) const { return cur == rhs.cur; }
+        bool operator!=(const iterator &rhs) const { return cur != rhs.cur; }
+    };
+
+    size_t size() const { return num_elem; }
+
+    void clear() {
+        free_slots();
+        std::fill(ctrl.begin(), ctrl.end(), ctrl_empty);
+        num_elem = 0;
+        num_deleted = 0;
+    }
+    /**
+     * double the slot array
+     */
+    void expand() { rebuild(slots.size() * 2); }
+    /**
+     * nothing to migrate, a swiss table is rehashed at once
+     */
+    void rehash_step() {}
+    size_t bucket_count() const { return slots.size(); }
+    float load_factor() const {
+        return static_cast<float>(num_elem) / slots.size();
+    }
+    float max_load_factor() const { return max_load; }
+    /**
+     * ml is capped at 7/8, a fuller table leaves the probe sequences
+     * without the empty slot that ends them.
+     * throw if ml is not positive
+     */
+    void max_load_factor(float ml) {
+        if (!(ml > 0)) throw "invalid";
+        max_load = std::min(ml, 0.875f);
+        if (num_elem + num_deleted > slots.size() * max_load)
+            rehash(bucket_count());
+    }
+    /**
+     * rebuild the table with at least cnt slots, rounded up to a power
+     * of two, and never fewer than size() needs under
+     * max_load_factor() or init_cnt. deleted slots are cleared.
+     * iterators are invalidated, nodes do not move
+     */
+    void rehash(size_t cnt) {
+        size_t need = static_cast<size_t>(std::ceil(num_elem / max_load));
+        cnt = std::max(cnt, std::max(need, init_cnt));
+        size_t n = init_cnt;
+        while (n < cnt) n <<= 1;
+        rebuild(n);
+    }
+    void reserve(size_t n) {
+        rehash(static_cast<size_t>(std::ceil(n / max_load)));
+    }
+    void shrink_to_fit() { rehash(0); }
+
+    iterator end() const { return iterator(this, slots.size(), nullptr); }
+
+    /**
+     * the node holding key, nullptr if not found
+     * idx is set to the slot of the key
+     */
+    template <class K>
+    Node *find_node(const K &key, int &idx) const {
+        return find_node(key, hash(key), idx);
+    }
+    /**
+     * the same, for a key whose hash is already known
+     */
+    template <class K>
+    Node *find_node(const K &key, size_t raw, int &idx) const {
+        size_t h = mix(raw);
+        size_t mask = slots.size() / group_width - 1;
+        size_t g = (h >> 7) & mask;
+        for (size_t step = 1;; ++step) {
+            unsigned bits = match_tag(g, static_cast<signed char>(h & 0x7F));
+            while (bits) {
+                int i = g * group_width + lowest_bit(bits);
+                if (slots[i]->may_equal(raw) &&
+                    equal(slots[i]->data.first, key)) {
+                    idx = i;
+                    return slots[i];
+                }
+                bits &= bits - 1;
+            }
+            if (match_tag(g, ctrl_empty)) break;
+            g = (g + step) & mask;
+        }
+        idx = slots.size();
+        return nullptr;
+    }
+    template <class K>
+    Node *find_node(const K &key) const {
+        int idx;
+        return find_node(key, idx);
+    }
+    template <class K, class... Args>
+    Node *try_emplace_node(K &&key, bool &inserted, int &idx,
+                           Args &&...args) {
+        size_t raw = hash(key);
+        Node *cur = find_node(key, raw, idx);
+        if (cur) {
+            inserted = false;
+            return cur;
+        }
+        inserted = true;
+        // keep at least one empty slot in every probe sequence, clear
+        // the deleted slots instead of growing while at most half of
+        // the load is live
+        if (num_elem + num_deleted + 1 > slots.size() * max_load) {
+            if ((num_elem + 1) * 2 > slots.size() * max_load) {
+                rebuild(slots.size() * 2);
+            } else {
+                rebuild(slots.size());
+            }
+        }
+        Node *newnode = new_node(
+            std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        newnode->store(raw);
+        size_t h = mix(raw);
+        idx = free_slot(h);
+        if (ctrl[idx] == ctrl_deleted) num_deleted--;
+        ctrl[idx] = static_cast<signed char>(h & 0x7F);
+        slots[idx] = newnode;
+        num_elem++;
+        return newnode;
+    }
+    /**
+     * take a node known to be in the map out of it without freeing it:
+     * its probe sequence comes from the hash of the node, and the slots
+     * whose tag matches are compared by address, not by key
+     */
+    void unlink_node(Node *node) {
+        size_t h = mix(node_hash(node));
+        size_t mask = slots.size() / group_width - 1;
+        size_t g = (h >> 7) & mask;
+        for (size_t step = 1;; ++step) {
+            unsigned bits = match_tag(g, static_cast<signed char>(h & 0x7F));
+            while (bits) {
+                int i = g * group_width + lowest_bit(bits);
+                if (slots[i] == node) {
+                    clear_slot(i);
+                    return;
+                }
+                bits &= bits - 1;
+            }
+            g = (g + step) & mask;
+        }
+    }
+    void destroy_node(Node *p) { node_traits::destroy(alloc, p); }
+    void deallocate_node(Node *p) { node_traits::deallocate(alloc, p, 1); }
+
+   protected:
+    using owner::new_node;
+    using owner::delete_node;
+
+    /**
+     * find_node for m <= lookup_batch keys, in three passes: every hash
+     * first, then the home groups of all of them are prefetched, then
+     * the nodes their tags match, and the keys are compared last
+     */
+    template <class K>
+    void find_batch(const K *keys, size_t m, Node **out, int *idx) const {
+        size_t raw[lookup_batch];
+        size_t mask = slots.size() / group_width - 1;
+        for (size_t i = 0; i < m; ++i) {
+            raw[i] = hash(keys[i]);
+            size_t g = (mix(raw[i]) >> 7) & mask;
+            prefetch(ctrl.data() + g * group_width);
+            prefetch(slots.data() + g * group_width);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            size_t h = mix(raw[i]);
+            size_t g = (h >> 7) & mask;
+            unsigned bits = match_tag(g, static_cast<signed char>(h & 0x7F));
+            if (bits) prefetch(slots[g * group_width + lowest_bit(bits)]);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            out[i] = find_node(keys[i], raw[i], idx[i]);
+        }
+    }
+    template <class K>
+    bool remove_key(const K &key) {
+        int idx;
+        Node *src = find_node(key, idx);
+        if (!src) return false;
+        delete_node(src);
+        clear_slot(idx);
+        return true;
+    }
+    void clear_slot(int idx) {
+        slots[idx] = nullptr;
+        // a group that still has an empty slot ends every probe
+        // sequence reaching it, so the slot can become empty again
+        if (match_tag(idx / group_width, ctrl_empty)) {
+            ctrl[idx] = ctrl_empty;
+        } else {
+            ctrl[idx] = ctrl_deleted;
+            num_deleted++;
+        }
+        num_elem--;
+    }
+    static size_t mix(size_t h) { return murmur_index::mix(h); }
+    size_t node_hash(const Node *node) const {
+        if constexpr (cached) {
+            return node->hash_code;
+        } else {
+            return hash(node->data.first);
+        }
+    }
+    static int lowest_bit(unsigned bits) {
+#if defined(__GNUC__)
+        return __builtin_ctz(bits);
+#else
+        int i = 0;
+        while (!(bits & 1u)) {
+            bits >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+    /**
+     * bit i is set if ctrl of the i-th slot in group g equals tag
+     */
+    unsigned match_tag(size_t g, signed char tag) const {
+        const signed char *base = ctrl.data() + g * group_width;
+#if defined(__SSE2__)
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(base));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), c));
+#else
+        unsigned bits = 0;
+        for (size_t i = 0; i < group_width; ++i) {
+            if (base[i] == tag) bits |= 1u << i;
+        }
+        return bits;
+#endif
+    }
+    /**
+     * bit i is set if the i-th slot in group g is empty or deleted
+     */
+    unsigned match_free(size_t g) const {
+        const signed char *base = ctrl.data() + g * group_width;
+#if defined(__SSE2__)
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(base));
+        return _mm_movemask_epi8(c);
+#else
+        unsigned bits = 0;
+        for (size_t i = 0; i < group_width; ++i) {
+            if (base[i] < 0) bits |= 1u << i;
+        }
+        return bits;
+#endif
+    }
+    /**
+     * the first empty or deleted slot on the probe sequence of h
+     */
+    size_t free_slot(size_t h) const {
+        size_t mask = slots.size() / group_width - 1;
+        size_t g = (h >> 7) & mask;
+        for (size_t step = 1;; ++step) {
+            unsigned bits = match_free(g);
+            if (bits) return g * group_width + lowest_bit(bits);
+            g = (g + step) & mask;
+        }
+    }
+    void rebuild(size_t cnt) {
+        std::vector<Node *> old_slots(cnt, nullptr);
+        old_slots.swap(slots);
+        ctrl.assign(cnt, ctrl_empty);
+        num_deleted = 0;
+        int s = old_slots.size();
+        for (int i = 0; i < s; ++i) {
+            if (old_slots[i]) {
+                size_t h = mix(node_hash(old_slots[i]));
+                size_t idx = free_slot(h);
+                ctrl[idx] = static_cast<signed char>(h & 0x7F);
+                slots[idx] = old_slots[i];
+            }
+        }
+    }
+    void copy_slots(const hashmap_table &other) {
+        int s = other.slots.size();
+        for (int i = 0; i < s; ++i) {
+            if (other.slots[i]) {
+                slots[i] = new_node(other.slots[i]->data);
+                static_cast<stored_hash<cached> &>(*slots[i]) = *other.slots[i];
+            }
+        }
+    }
+    void free_slots() {
+        int s = slots.size();
+        for (int i = 0; i < s; ++i) {
+            if (slots[i]) {
+                delete_node(slots[i]);
+                slots[i] = nullptr;
+            }
+        }
+    }
+};
+
+/**
+ * Storage selects the table under the map, see hashmap_table. the
+ * insertion and lookup interface is written once for every storage on
+ * top of what a table provides: try_emplace_node, find_node,
+ * find_batch, remove_key, reserve and rehash_step
+ */
+template <class Key, class T, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key>, class Storage = chained_storage,
+          class Index = prime_index,
+          class Alloc = std::allocator<pair<const Key, T> > >
+class hashmap
+    : public hashmap_table<Key, T, Hash, Equal, Storage, Index, Alloc> {
+   public:
+    using table = hashmap_table<Key, T, Hash, Equal, Storage, Index, Alloc>;
+    using value_type = pair<const Key, T>;
+    using Node = typename table::Node;
+    using iterator = typename table::iterator;
+    using typename table::node_allocator;
+    using table::lookup_batch;
+
+    hashmap() {}
+    template <class InputIt>
+    hashmap(InputIt first, InputIt last) {
+        insert_range(first, last);
+    }
+
+    /**
+     * find, return a pointer point to the value
+     * not find, return the end (point to nothing)
+     */
+    iterator find(const Key &key) const { return find_key(key); }
+    iterator find(const Key &key) {
+        this->rehash_step();
+        return find_key(key);
+    }
+    /**
+     * the same for a transparent Hash and Equal, without building a Key
+     */
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    iterator find(const K &key) const {
+        return find_key(key);
+    }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    iterator find(const K &key) {
+        this->rehash_step();
+        return find_key(key);
+    }
+    /**
+     * out[i] = find(keys[i]) for the n keys. the lookups go in batches
+     * of lookup_batch, the table prefetches what the keys of a batch
+     * need before comparing any of them, so their cache misses overlap
+     */
+    void find_many(const Key *keys, size_t n, iterator *out) const {
+        find_many_keys(keys, n, out);
+    }
+    void find_many(const Key *keys, size_t n, iterator *out) {
+        this->rehash_step();
+        find_many_keys(keys, n, out);
+    }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    void find_many(const K *keys, size_t n, iterator *out) const {
+        find_many_keys(keys, n, out);
+    }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    void find_many(const K *keys, size_t n, iterator *out) {
+        this->rehash_step();
+        find_many_keys(keys, n, out);
+    }
+    /**
+     * the same, giving the nodes, nullptr for a missing key
+     */
+    template <class K>
+    void find_nodes(const K *keys, size_t n, Node **out) const {
+        int idx[lookup_batch];
+        for (size_t i = 0; i < n; i += lookup_batch) {
+            this->find_batch(keys + i, std::min(lookup_batch, n - i), out + i,
+                             idx);
+        }
+    }
+    /**
+     * return the node holding value_pair.first after the insertion,
+     * inserted is set to false if the key existed and only
+     * the value got updated
+     */
+    Node *insert_node(const value_type &value_pair, bool &inserted,
+                      int &idx) {
+        Node *cur = this->try_emplace_node(value_pair.first, inserted, idx,
+                                           value_pair.second);
+        if (!inserted) cur->data.second = value_pair.second;
+        return cur;
+    }
+    Node *insert_node(const value_type &value_pair, bool &inserted) {
+        int idx;
+        return insert_node(value_pair, inserted, idx);
+    }
+    /**
+     * the same, the value is moved into the node or onto the old value
+     */
+    Node *insert_node(value_type &&value_pair, bool &inserted, int &idx) {
+        Node *cur = this->try_emplace_node(value_pair.first, inserted, idx,
+                                           std::move(value_pair.second));
+        if (!inserted) cur->data.second = std::move(value_pair.second);
+        return cur;
+    }
+    /**
+     * already have a value_pair with the same key
+     * -> just update the value, return false
+     * not find a value_pair with the same key
+     * -> insert the value_pair, return true
+     */
+    sjtu::pair<iterator, bool> insert(const value_type &value_pair) {
+        bool flag;
+        int idx;
+        Node *cur = insert_node(value_pair, flag, idx);
+        auto it = iterator(this, idx, cur);
+        return sjtu::pair<iterator, bool>(it, flag);
+    }
+    sjtu::pair<iterator, bool> insert(value_type &&value_pair) {
+        bool flag;
+        int idx;
+        Node *cur = insert_node(std::move(value_pair), flag, idx);
+        return sjtu::pair<iterator, bool>(iterator(this, idx, cur), flag);
+    }
+    /**
+     * if key doesn't exist, build its value in place from args and
+     * return true, the arguments are forwarded so nothing is copied
+     * and a move-only value can be stored.
+     * if it exists, change nothing and return false
+     */
+    template <class K, class... Args>
+    sjtu::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+        bool flag;
+        int idx;
+        Node *cur = this->try_emplace_node(std::forward<K>(key), flag, idx,
+                                           std::forward<Args>(args)...);
+        return sjtu::pair<iterator, bool>(iterator(this, idx, cur), flag);
+    }
+    /**
+     * try_emplace(key, value): the node is built only once key is
+     * known to be missing, not before the lookup as in std::unordered_map
+     */
+    template <class K, class V>
+    sjtu::pair<iterator, bool> emplace(K &&key, V &&value) {
+        return try_emplace(std::forward<K>(key), std::forward<V>(value));
+    }
+    /**
+     * try_emplace, but an existing value is assigned value
+     */
+    template <class K, class V>
+    sjtu::pair<iterator, bool> insert_or_assign(K &&key, V &&value) {
+        auto res = try_emplace(std::forward<K>(key), std::forward<V>(value));
+        // value is untouched when the key existed
+        if (!res.second) (*res.first).second = std::forward<V>(value);
+        return res;
+    }
+    /**
+     * insert every pair of [first, last) as insert does. when the
+     * length of the range is known, the table is sized once and, if
+     * it is empty, the allocator sets the nodes aside in one block
+     * when it can. keys already there would leave such nodes unused
+     */
+    template <class InputIt>
+    void insert_range(InputIt first, InputIt last) {
+        reserve_range(first, last);
+        for (; first != last; ++first) {
+            bool inserted;
+            int idx;
+            Node *cur = this->try_emplace_node((*first).first, inserted, idx,
+                                               (*first).second);
+            if (!inserted) cur->data.second = (*first).second;
+        }
+    }
+    template <class InputIt>
+    void reserve_range(InputIt first, InputIt last) {
+        if constexpr (is_forward_iterator<InputIt>::value) {
+            size_t n = std::distance(first, last);
+            if constexpr (has_reserve<node_allocator>::value) {
+                if (this->num_elem == 0) this->alloc.reserve(n);
+            }
+            this->reserve(this->num_elem + n);
+        }
+    }
+    /**
+     * the value_pair exists, remove and return true
+     * otherwise, return false
+     */
+    bool remove(const Key &key) { return this->remove_key(key); }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    bool remove(const K &key) {
+        return this->remove_key(key);
+    }
+
+   private:
+    template <class K>
+    iterator find_key(const K &key) const {
+        int idx;
+        Node *src = this->find_node(key, idx);
+        if (src) return iterator(this, idx, src);
+        return this->end();
+    }
+    template <class K>
+    void find_many_keys(const K *keys, size_t n, iterator *out) const {
+        Node *found[lookup_batch];
+        int idx[lookup_batch];
+        for (size_t i = 0; i < n; i += lookup_batch) {
+            size_t m = std::min(lookup_batch, n - i);
+            this->find_batch(keys + i, m, found, idx);
+            for (size_t j = 0; j < m; ++j) {
+                out[i + j] =
+                    found[j] ? iterator(this, idx[j], found[j]) : this->end();
+            }
+        }
+    }
+};
+
+/**
+ * a chained hashmap for many threads where readers take no lock.
+ * a node never changes once it is reachable: an update links a new
+ * node in place of the old one, and the old node goes to the
+ * epoch_domain, which frees it when no reader can hold it any more.
+ * writers lock the stripe of their bucket.
+ * growing does not stop the map: a bigger table is hung on the current
+ * one, and every thread that meets it claims a run of old buckets and
+ * moves them, leaving a forwarding marker in each one moved, like the
+ * transfer of Java's ConcurrentHashMap. a lookup that finds a marker
+ * goes on in the new table. the thread moving the last run makes the
+ * new table current.
+ * nothing hands out a pointer into the map: find copies the value,
+ * visit runs a function on it while the reader is still protected.
+ */
+template <class Key, class T, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key> >
+class concurrent_hashmap {
+   public:
+    typedef pair<const Key, T> value_type;
+    static constexpr size_t stripe_count = 64;
+    // the old buckets a thread claims at once while the map grows
+    static constexpr size_t transfer_batch = 64;
+
+    explicit concurrent_hashmap(size_t buckets = 16) : num_elem(0) {
+        size_t n = std::max<size_t>(fibonacci_index::size(buckets),
+                                    stripe_count);
+        current.store(new table(n));
+    }
+    concurrent_hashmap(const concurrent_hashmap &) = delete;
+    concurrent_hashmap &operator=(const concurrent_hashmap &) = delete;
+    /**
+     * no other thread may use the map any more
+     */
+    ~concurrent_hashmap() { free_table(current.load()); }
+
+    size_t size() const { return num_elem.load(std::memory_order_relaxed); }
+    size_t bucket_count() const { return current.load()->mask + 1; }
+    /**
+     * copy the value of key into out, return false if not found
+     */
+    bool find(const Key &key, T &out) const {
+        return visit(key, [&out](const T &value) { out = value; });
+    }
+    size_t count(const Key &key) const {
+        return visit(key, [](const T &) {});
+    }
+    /**
+     * call f(value) if key is found, the value stays valid until f
+     * returns even if another thread removes it meanwhile
+     */
+    template <class F>
+    bool visit(const Key &key, F f) const {
+        epoch_guard guard;
+        size_t h = hash_of(key);
+        const table *t = current.load(std::memory_order_acquire);
+        node *cur = t->heads[h & t->mask].load(std::memory_order_acquire);
+        while (cur == moved()) {
+            t = t->next.load(std::memory_order_acquire);
+            cur = t->heads[h & t->mask].load(std::memory_order_acquire);
+        }
+        while (cur) {
+            if (cur->h == h && equal(cur->data.first, key)) {
+                f(static_cast<const T &>(cur->data.second));
+                return true;
+            }
+            cur = cur->next.load(std::memory_order_acquire);
+        }
+        return false;
+    }
+    /**
+     * insert the value_pair, or replace the value if the key exists,
+     * return true if it was inserted
+     */
+    bool insert(const value_type &value) {
+        return insert_or_assign(value.first, value.second);
+    }
+    template <class K, class V>
+    bool insert_or_assign(K &&key, V &&value) {
+        return put(true, std::forward<K>(key), std::forward<V>(value));
+    }
+    /**
+     * build the value of key in place from args if key is missing,
+     * return false and change nothing if it exists
+     */
+    template <class K, class... Args>
+    bool try_emplace(K &&key, Args &&...args) {
+        return put(false, std::forward<K>(key), std::forward<Args>(args)...);
+    }
+    /**
+     * the value_pair exists, remove and return true
+     * otherwise, return false
+     */
+    bool remove(const Key &key) {
+        epoch_guard guard;
+        size_t h = hash_of(key);
+        std::unique_lock<std::mutex> lock;
+        table *t = lock_bucket(h, lock);
+        std::atomic<node *> *link = &t->heads[h & t->mask];
+        while (node *cur = link->load(std::memory_order_relaxed)) {
+            if (cur->h == h && equal(cur->data.first, key)) {
+                link->store(cur->next.load(std::memory_order_relaxed),
+                            std::memory_order_release);
+                num_elem.fetch_sub(1, std::memory_order_relaxed);
+                epoch_domain::instance().retire(cur, &free_node);
+                return true;
+            }
+            link = &cur->next;
+        }
+        return false;
+    }
+
+   private:
+    struct node {
+        value_type data;
+        size_t h;
+        std::atomic<node *> next;
+        template <class... Args>
+        node(size_t h, node *next, Args &&...args)
+            : data(std::forward<Args>(args)...), h(h), next(next) {}
+    };
+    struct table {
+        size_t mask;
+        std::atomic<node *> *heads;
+        // the table being filled from this one, if it grows
+        std::atomic<table *> next;
+        // old buckets handed out to movers, and moved
+        std::atomic<size_t> claimed, done;
+        explicit table(size_t n)
+            : mask(n - 1),
+              heads(new std::atomic<node *>[n]),
+              next(nullptr),
+              claimed(0),
+              done(0) {
+            for (size_t i = 0; i < n; ++i) heads[i].store(nullptr);
+        }
+        ~table() { delete[] heads; }
+    };
+    // bucket i is guarded by stripe i % stripe_count, whatever the
+    // size of the table: an old bucket and the two new buckets it
+    // splits into share a stripe
+    struct alignas(64) stripe {
+        std::mutex m;
+    };
+
+    std::atomic<table *> current;
+    std::atomic<size_t> num_elem;
+    stripe locks[stripe_count];
+    Hash hash;
+    Equal equal;
+
+    /**
+     * the head of a bucket already moved to the next table
+     */
+    static node *moved() {
+        static node *const marker = reinterpret_cast<node *>(alignof(node));
+        return marker;
+    }
+    /**
+     * buckets and stripes take the low bits of the mixed hash, as an
+     * identity hash such as std::hash<int> piles strided keys into a
+     * few buckets. nodes keep the mixed hash, so moving agrees
+     */
+    template <class K>
+    size_t hash_of(const K &key) const {
+        return murmur_index::mix(hash(key));
+    }
+    static void free_node(void *p) { delete static_cast<node *>(p); }
+    // a table whose buckets were all moved owns no node
+    static void free_moved(void *p) { delete static_cast<table *>(p); }
+    static void free_table(void *p) {
+        table *t = static_cast<table *>(p);
+        for (size_t i = 0; i <= t->mask; ++i) {
+            node *cur = t->heads[i].load(std::memory_order_relaxed);
+            if (cur == moved()) continue;
+            while (cur) {
+                node *next = cur->next.load(std::memory_order_relaxed);
+                delete cur;
+                cur = next;
+            }
+        }
+        delete t;
+    }
+
+    /**
+     * lock the stripe of hash h and return the table holding its
+     * bucket, helping to move buckets on the way if the map grows.
+     * the caller is inside an epoch_guard
+     */
+    table *lock_bucket(size_t h, std::unique_lock<std::mutex> &lock) {
+        table *t = current.load(std::memory_order_acquire);
+        lock = std::unique_lock<std::mutex>(locks[h & (stripe_count - 1)].m);
+        while (t->heads[h & t->mask].load(std::memory_order_relaxed) ==
+               moved()) {
+            lock.unlock();
+            help(t);
+            t = t->next.load(std::memory_order_acquire);
+            lock.lock();
+        }
+        return t;
+    }
+    /**
+     * insert key with a value built from args, if key exists replace
+     * its node by one built that way when assign, or leave it alone
+     */
+    template <class K, class... Args>
+    bool put(bool assign, K &&key, Args &&...args) {
+        epoch_guard guard;
+        size_t h = hash_of(key);
+        {
+            std::unique_lock<std::mutex> lock;
+            table *t = lock_bucket(h, lock);
+            std::atomic<node *> *head = &t->heads[h & t->mask];
+            std::atomic<node *> *link = head;
+            while (node *cur = link->load(std::memory_order_relaxed)) {
+                if (cur->h == h && equal(cur->data.first, key)) {
+                    if (!assign) return false;
+                    node *fresh = new node(
+                        h, cur->next.load(std::memory_order_relaxed),
+                        std::piecewise_construct,
+                        std::forward_as_tuple(std::forward<K>(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+                    link->store(fresh, std::memory_order_release);
+                    epoch_domain::instance().retire(cur, &free_node);
+                    return false;
+                }
+                link = &cur->next;
+            }
+            node *fresh = new node(
+                h, head->load(std::memory_order_relaxed),
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+            head->store(fresh, std::memory_order_release);
+        }
+        size_t n = num_elem.fetch_add(1, std::memory_order_relaxed) + 1;
+        table *t = current.load(std::memory_order_acquire);
+        if (n > (t->mask + 1) * 3 / 4) grow(t);
+        return true;
+    }
+    /**
+     * hang a table twice as big on t, unless some thread did already,
+     * and help to fill it
+     */
+    void grow(table *t) {
+        if (!t->next.load(std::memory_order_acquire)) {
+            table *bigger = new table((t->mask + 1) * 2);
+            table *none = nullptr;
+            if (!t->next.compare_exchange_strong(none, bigger)) delete bigger;
+        }
+        help(t);
+    }
+    /**
+     * move runs of buckets of t to t->next until none is left to claim,
+     * the thread finishing the last run makes t->next current
+     */
+    void help(table *t) {
+        table *to = t->next.load(std::memory_order_acquire);
+        size_t n = t->mask + 1;
+        for (;;) {
+            size_t from = t->claimed.fetch_add(transfer_batch);
+            if (from >= n) return;
+            size_t stop = std::min(n, from + transfer_batch);
+            for (size_t i = from; i < stop; ++i) {
+                std::lock_guard<std::mutex> lock(
+                    locks[i & (stripe_count - 1)].m);
+                move_bucket(t, to, i);
+            }
+            if (t->done.fetch_add(stop - from) + (stop - from) == n) {
+                current.store(to, std::memory_order_release);
+                epoch_domain::instance().retire(t, &free_moved);
+                return;
+            }
+        }
+    }
+    /**
+     * split bucket i of from into buckets i and i + n of to, under the
+     * lock of its stripe. the tail of the chain going to one bucket is
+     * linked as it is, the nodes before it are copied: readers may
+     * still be walking the old chain
+     */
+    void move_bucket(table *from, table *to, size_t i) {
+        size_t n = from->mask + 1;
+        node *head = from->heads[i].load(std::memory_order_relaxed);
+        node *last = head;
+        for (node *cur = head; cur;
+             cur = cur->next.load(std::memory_order_relaxed)) {
+            if ((cur->h & n) != (last->h & n)) last = cur;
+        }
+        std::atomic<node *> *lo = &to->heads[i], *hi = &to->heads[i + n];
+        if (last) ((last->h & n) ? hi : lo)->store(last, std::memory_order_relaxed);
+        for (node *cur = head; cur != last;) {
+            std::atomic<node *> *dest = (cur->h & n) ? hi : lo;
+            dest->store(new node(cur->h, dest->load(std::memory_order_relaxed),
+                                 cur->data),
+                        std::memory_order_relaxed);
+            cur = cur->next.load(std::memory_order_relaxed);
+        }
+        // the new chains are complete before a reader can follow the
+        // marker to them
+        from->heads[i].store(moved(), std::memory_order_release);
+        for (node *cur = head; cur != last;) {
+            node *next = cur->next.load(std::memory_order_relaxed);
+            epoch_domain::instance().retire(cur, &free_node);
+            cur = next;
+        }
+    }
+};
+
+template <class Key, class T, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key>, class Storage = chained_storage,
+          class Index = prime_index,
+          class Alloc = std::allocator<pair<const Key, T> > >
+class linked_hashmap
+    : public hashmap<Key, T, Hash, Equal, Storage, Index, Alloc> {
+   public:
+    typedef pair<const Key, T> value_type;
+    using base_map = hashmap<Key, T, Hash, Equal, Storage, Index, Alloc>;
+    using Node = typename base_map::Node;
+    using list_type = double_list<value_type, Alloc>;
+    using list_iterator = typename list_type::iterator;
+    // the order list links the nodes of base_map, it owns nothing
+    list_type db;
+
+    class const_iterator;
+
+    class iterator {
+       public:
+        list_iterator list_iter;
+        /**
+         * elements
+         * add whatever you want
+         */
+        // --------------------------
+        iterator() {}
+        iterator(const list_iterator &it)
+            : list_iter(it) {}
+        iterator(const iterator &other) : list_iter(other.list_iter) {}
+        ~iterator() {}
+
+        /**
+         * iter++
+         */
+        iterator operator++(int) { 
+            iterator tmp = *this;
             ++list_iter; 
             return tmp;
         }
-        /**
-         * ++iter
-         */
-        iterator &operator++() {
-            ++list_iter;
-            return *this;
+        /**
+         * ++iter
+         */
+        iterator &operator++() {
+            ++list_iter;
+            return *this;
+        }
+        /**
+         * iter--
+         */
+        iterator operator--(int) { 
+            iterator tmp = *this;
+            --list_iter; 
+            return tmp;
+        }
+        /**
+         * --iter
+         */
+        iterator &operator--() {
+            --list_iter;
+            return *this;
+        }
+
+        /**
+         * if the iter didn't point to a value
+         * throw "star invalid"
+         */
+        value_type &operator*() const {
+            if (list_iter.cur == nullptr) {
+                throw "star invalid";
+            }
+            return *list_iter;
+        }
+        value_type *operator->() const noexcept {
+            if (list_iter.cur == nullptr) {
+                throw "star invalid";
+            }
+            return &(*list_iter);
+        }
+
+        /**
+         * operator to check whether two iterators are same (pointing to the
+         * same memory).
+         */
+        bool operator==(const iterator &rhs) const {
+            return list_iter == rhs.list_iter;
+        }
+        bool operator!=(const iterator &rhs) const {
+            return list_iter != rhs.list_iter;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return list_iter == rhs.list_iter;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return list_iter != rhs.list_iter;
+        }
+    };
+
+    class const_iterator {
+       public:
+        typename list_type::const_iterator list_iter;
+        /**
+         * elements
+         * add whatever you want
+         */
+        // --------------------------
+        const_iterator() {}
+        const_iterator(
+            const typename list_type::const_iterator &it)
+            : list_iter(it) {}
+        const_iterator(const iterator &other) : list_iter(other.list_iter) {}
+        const_iterator(const const_iterator &other)
+            : list_iter(other.list_iter) {}
+
+        /**
+         * iter++
+         */
+        const_iterator operator++(int) {
+            const_iterator tmp(list_iter);
+            ++list_iter;
+            return tmp;
+        }
+        /**
+         * ++iter
+         */
+        const_iterator &operator++() {
+            ++list_iter;
+            return *this;
+        }
+        /**
+         * iter--
+         */
+        const_iterator operator--(int) {
+            const_iterator tmp(list_iter);
+            --list_iter;
+            return tmp;
+        }
+        /**
+         * --iter
+         */
+        const_iterator &operator--() {
+            --list_iter;
+            return *this;
+        }
+
+        /**
+         * if the iter didn't point to a value
+         * throw
+         */
+        const value_type &operator*() const {
+            if (list_iter.cur == nullptr) {
+                throw "star invalid";
+            }
+            return *list_iter;
+        }
+        const value_type *operator->() const noexcept {
+            if (list_iter.cur == nullptr) {
+                throw "star invalid";
+            }
+            return &(*list_iter);
+        }
+
+        /**
+         * operator to check whether two iterators are same (pointing to the
+         * same memory).
+         */
+        bool operator==(const iterator &rhs) const {
+            return list_iter == rhs.list_iter;
+        }
+        bool operator!=(const iterator &rhs) const {
+            return list_iter != rhs.list_iter;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return list_iter == rhs.list_iter;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return list_iter != rhs.list_iter;
+        }
+    };
+
+    linked_hashmap() : base_map(), db() {}
+    template <class InputIt>
+    linked_hashmap(InputIt first, InputIt last) : base_map(), db() {
+        insert_range(first, last);
+    }
+    linked_hashmap(const linked_hashmap &other) : base_map(), db() {
+        for (auto it = other.db.begin(); it != other.db.end(); ++it) {
+            this->insert(*it);
+        }
+    }
+    ~linked_hashmap() { db.release(); }
+    linked_hashmap &operator=(const linked_hashmap &other) {
+        if (this == &other) return *this;
+        this->clear();
+        for (auto it = other.db.begin(); it != other.db.end(); ++it) {
+            this->insert(*it);
+        }
+        return *this;
+    }
+
+    /**
+     * return the value connected with the Key(O(1))
+     * if the key not found, throw
+     */
+    T &at(const Key &key) {
+        this->rehash_step();
+        return at_key(key);
+    }
+    const T &at(const Key &key) const { return at_key(key); }
+    /**
+     * the same for a transparent Hash and Equal, without building a Key,
+     * and so are count, find and touch
+     */
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    T &at(const K &key) {
+        this->rehash_step();
+        return at_key(key);
+    }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    const T &at(const K &key) const {
+        return at_key(key);
+    }
+    T &operator[](const Key &key) { return at(key); }
+    const T &operator[](const Key &key) const { return at(key); }
+
+    /**
+     * return an iterator point to the first
+     * inserted and existed element
+     */
+    iterator begin() { return iterator(db.begin()); }
+    const_iterator cbegin() const { return const_iterator(db.begin()); }
+    /**
+     * return an iterator after the last inserted element
+     */
+    iterator end() { return iterator(db.end()); }
+    const_iterator cend() const { return const_iterator(db.end()); }
+    /**
+     * if didn't contain anything, return true,
+     * otherwise false.
+     */
+    bool empty() const {
+        if (db.empty()) return true;
+        return false;
+    }
+
+    void clear() {
+        db.release();
+        base_map::clear();
+    }
+
+    size_t size() const { return this->num_elem; }
+    /**
+     * insert the value_piar
+     * if the key of the value_pair exists in the map
+     * update the value instead of adding a new element，
+     * then the order of the element moved from inner of the
+     * list to the head of the list
+     * and return false
+     * if the key of the value_pair doesn't exist in the map
+     * add a new element and return true
+     */
+    pair<iterator, bool> insert(const value_type &value) {
+        bool flag;
+        Node *cur = this->insert_node(value, flag);
+        if (flag)
+            db.link_tail(cur);
+        else
+            db.move_to_tail(list_iterator(cur));
+        auto it = iterator(list_iterator(cur));
+        return sjtu::pair<iterator, bool>(it, flag);
+    }
+    /**
+     * insert every pair of [first, last) as insert does, sized up front
+     * like hashmap::insert_range. the new nodes are chained in input
+     * order as they come and linked to the tail of the list at once
+     */
+    template <class InputIt>
+    void insert_range(InputIt first, InputIt last) {
+        this->reserve_range(first, last);
+        sjtu::Node<value_type> *head = nullptr, *tail = nullptr;
+        sjtu::Node<value_type> **link = &head;
+        try {
+            for (; first != last; ++first) {
+                bool inserted;
+                int idx;
+                Node *cur = this->try_emplace_node((*first).first, inserted,
+                                                   idx, (*first).second);
+                if (inserted) {
+                    cur->prev = tail;
+                    *link = cur;
+                    link = &cur->next;
+                    tail = cur;
+                    continue;
+                }
+                cur->data.second = (*first).second;
+                // an existing key goes to the tail too, after the new ones
+                if (head) db.link_tail(head, tail);
+                head = tail = nullptr;
+                link = &head;
+                db.move_to_tail(list_iterator(cur));
+            }
+        } catch (...) {
+            // the chained nodes are in the table already
+            if (head) db.link_tail(head, tail);
+            throw;
+        }
+        if (head) db.link_tail(head, tail);
+    }
+    /**
+     * if key doesn't exist, build its value in place from args at the
+     * tail of the list and return true, the arguments are forwarded so
+     * a move-only value can be stored.
+     * if it exists, change nothing and return false
+     */
+    template <class K, class... Args>
+    pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+        bool flag;
+        int idx;
+        Node *cur = this->try_emplace_node(std::forward<K>(key), flag, idx,
+                                           std::forward<Args>(args)...);
+        if (flag) db.link_tail(cur);
+        return pair<iterator, bool>(iterator(list_iterator(cur)), flag);
+    }
+    /**
+     * insert, moving the value into the node or onto the old value
+     */
+    pair<iterator, bool> insert(value_type &&value) {
+        return insert_or_assign(value.first, std::move(value.second));
+    }
+    /**
+     * try_emplace(key, value), see hashmap::emplace
+     */
+    template <class K, class V>
+    pair<iterator, bool> emplace(K &&key, V &&value) {
+        return try_emplace(std::forward<K>(key), std::forward<V>(value));
+    }
+    /**
+     * try_emplace, but an existing value is assigned value and moved
+     * to the tail, as insert does
+     */
+    template <class K, class V>
+    pair<iterator, bool> insert_or_assign(K &&key, V &&value) {
+        auto res = try_emplace(std::forward<K>(key), std::forward<V>(value));
+        if (!res.second) {
+            // value is untouched when the key existed
+            (*res.first).second = std::forward<V>(value);
+            db.move_to_tail(res.first.list_iter);
+        }
+        return res;
+    }
+    /**
+     * move the element of key to the tail of the list, as if it was
+     * inserted again, without touching its value.
+     * return the iterator of the element, or end() if key is not found
+     */
+    iterator touch(const Key &key) { return touch_key(key); }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    iterator touch(const K &key) {
+        return touch_key(key);
+    }
+    /**
+     * the same, for an element already found
+     */
+    void touch(iterator pos) { db.move_to_tail(pos.list_iter); }
+    /**
+     * erase the value_pair pointed by the iterator
+     * if the iterator points to nothing
+     * throw
+     */
+    void remove(iterator pos) {
+        this->delete_node(extract(pos));
+    }
+    /**
+     * take the element of pos out of the map without freeing it,
+     * see hashmap::extract_node. the node is unlinked where it is,
+     * the key is not looked up again
+     */
+    Node *extract(iterator pos) {
+        if (pos == end()) throw "iterator invalid";
+        Node *cur = static_cast<Node *>(pos.list_iter.cur);
+        db.unlink(cur);
+        this->unlink_node(cur);
+        return cur;
+    }
+    /**
+     * return how many value_pairs consist of key
+     * this should only return 0 or 1
+     */
+    size_t count(const Key &key) const { return this->find_node(key) ? 1 : 0; }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    size_t count(const K &key) const {
+        return this->find_node(key) ? 1 : 0;
+    }
+    /**
+     * find the iterator points at the value_pair
+     * which consist of key
+     * if not find, return the iterator
+     * point at nothing
+     */
+    iterator find(const Key &key) { return find_key(key); }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    iterator find(const K &key) {
+        return find_key(key);
+    }
+    /**
+     * out[i] = find(keys[i]) for the n keys, with the cache misses of a
+     * batch overlapped, see hashmap::find_many
+     */
+    void find_many(const Key *keys, size_t n, iterator *out) {
+        find_many_keys(keys, n, out);
+    }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    void find_many(const K *keys, size_t n, iterator *out) {
+        find_many_keys(keys, n, out);
+    }
+
+   private:
+    template <class K>
+    T &at_key(const K &key) const {
+        Node *src = this->find_node(key);
+        if (!src) throw "invalid";
+        return src->data.second;
+    }
+    template <class K>
+    iterator touch_key(const K &key) {
+        this->rehash_step();
+        Node *src = this->find_node(key);
+        if (!src) return end();
+        db.move_to_tail(list_iterator(src));
+        return iterator(list_iterator(src));
+    }
+    template <class K>
+    iterator find_key(const K &key) {
+        this->rehash_step();
+        Node *src = this->find_node(key);
+        if (src) return iterator(list_iterator(src));
+        return db.end();
+    }
+    template <class K>
+    void find_many_keys(const K *keys, size_t n, iterator *out) {
+        this->rehash_step();
+        const size_t batch = base_map::lookup_batch;
+        Node *found[batch];
+        for (size_t i = 0; i < n; i += batch) {
+            size_t m = std::min(batch, n - i);
+            this->find_nodes(keys + i, m, found);
+            for (size_t j = 0; j < m; ++j) {
+                out[i + j] =
+                    found[j] ? iterator(list_iterator(found[j])) : db.end();
+            }
+        }
+    }
+};
+
+/**
+ * eviction policies of basic_lru, its last template parameter
+ * lru_policy: evict the least recently used entry
+ * clock_policy: LRU approximated by a second-chance bit per entry and a
+ *   hand sweeping a ring, a hit only sets the bit and relinks nothing
+ * slru_policy: segmented LRU, new entries wait in a probation segment,
+ *   a hit moves them to a protected segment holding 80% of the capacity
+ * two_queue_policy: 2Q, new entries go through a FIFO (a quarter of the
+ *   capacity), the keys it drops are remembered for a while and only
+ *   entries seen again there get into the main LRU queue
+ * arc_policy: ARC, a recency and a frequency LRU list plus the keys
+ *   recently dropped from each, their hits adapt the split between them
+ * weighted_lru_policy<Weigher>: LRU, but the capacity bounds the total
+ *   weight of the values instead of their number, see byte_weigher
+ * lfu_policy: evict the least frequently used entry, the oldest first,
+ *   frequencies are kept in O(1) buckets
+ * w_tinylfu_policy: a small LRU window in front of a segmented LRU,
+ *   an entry leaving the window only gets in if a count-min sketch
+ *   says it is used more often than the entry it would replace
+ * scans (keys used once) flush plain LRU, the others keep the entries
+ * used more than once.
+ */
+struct lru_policy {};
+struct clock_policy {};
+struct slru_policy {};
+struct two_queue_policy {};
+struct arc_policy {};
+struct lfu_policy {};
+struct w_tinylfu_policy {};
+
+/**
+ * the storage of a basic_lru with a given policy. all of them have
+ *   eviction(capacity)
+ *   size()
+ *   get(key): the value of key or nullptr, counts as a use of key
+ *   try_emplace(key, args...): if key is missing, build its value in
+ *     place and evict something if necessary, otherwise only use key.
+ *     return the value (nullptr if it got evicted right away, when the
+ *     capacity is 0) and whether it was inserted
+ *   insert_or_assign(key, value): the same, but an existing value is
+ *     replaced
+ *   for_each(f): call f(key, value) from the next entry to be evicted on
+ * and a get split in two, so the lookup can run alongside other lookups
+ * and the use be recorded later:
+ *   find(key): the handle of key or nullptr, only reads the map
+ *   value_of(handle): the value of a handle
+ *   touch(handle): count a use of the entry, which must still be cached
+ */
+template <class Policy, class Key, class Value, class Hash, class Equal,
+          class Alloc = pool_allocator<pair<const Key, Value> > >
+class eviction;
+
+/**
+ * the allocator of a cache rebound to the nodes of one of its containers
+ */
+template <class Alloc, class T>
+using alloc_for =
+    typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+/**
+ * the weight of a value in a weighted_lru_policy cache
+ * unit_weigher: every entry weighs 1, the capacity counts entries
+ * byte_weigher: the bytes of the value, the elements of a Matrix or
+ *   sizeof(Value), the capacity is a byte budget
+ * any class with size_t operator()(const Value &) const will do
+ */
+struct unit_weigher {
+    template <class Value>
+    size_t operator()(const Value &) const {
+        return 1;
+    }
+};
+struct byte_weigher {
+    template <class Value>
+    size_t operator()(const Value &) const {
+        return sizeof(Value);
+    }
+    template <class T>
+    size_t operator()(const Matrix<T> &value) const {
+        return value.RowSize() * value.ColSize() * sizeof(T);
+    }
+};
+template <class Weigher = byte_weigher>
+struct weighted_lru_policy {};
+
+/**
+ * a cached value together with the bookkeeping of its policy
+ */
+template <class Value, class Meta>
+class cache_entry {
+   public:
+    Value value;
+    Meta meta;
+    template <class... Args>
+    cache_entry(Args &&...args) : value(std::forward<Args>(args)...), meta() {}
+};
+
+/**
+ * LRU holding at most capacity of total weight, a save evicts from the
+ * least recently used end until the weights fit again.
+ * the weight of a value is taken when it is saved and kept next to it
+ * (the meta of a cache_entry), eviction gives back that weight:
+ * changing a value through the pointer of get() does not reweigh it.
+ * unit weights cannot drift, so plain LRU keeps the value alone.
+ */
+template <class Weigher, class Key, class Value, class Hash, class Equal,
+          class Alloc>
+class eviction<weighted_lru_policy<Weigher>, Key, Value, Hash, Equal, Alloc> {
+   public:
+    static constexpr bool unit = std::is_same<Weigher, unit_weigher>::value;
+    using stored =
+        typename std::conditional<unit, Value,
+                                  cache_entry<Value, size_t> >::type;
+    using value_type = sjtu::pair<const Key, stored>;
+    // every eviction frees a node that the next save reuses
+    using lmap = sjtu::linked_hashmap<Key, stored, Hash, Equal,
+                                      sjtu::chained_storage, sjtu::prime_index,
+                                      alloc_for<Alloc, value_type> >;
+
+    lmap mp;
+
+    explicit eviction(size_t capacity) : cap(capacity), total(0), slack(0) {}
+    size_t size() const { return mp.size(); }
+    /**
+     * the total weight of the entries
+     */
+    size_t weight() const { return total; }
+    /**
+     * let the weights go up to capacity + slack before a save evicts,
+     * the entries above capacity are left to trim
+     */
+    void set_slack(size_t s) { slack = s; }
+    /**
+     * trim has something to evict
+     */
+    bool over() const { return total > cap; }
+    /**
+     * evict at most budget of the oldest entries until the weights fit
+     * the capacity, return how many were evicted.
+     * each entry is taken out but not freed: take(e) gets it, and it is
+     * left to destroy(e), which may run without the lock of the cache,
+     * then release(e)
+     */
+    using evicted = typename lmap::Node *;
+    template <class F>
+    size_t trim(size_t budget, F take) {
+        size_t done = 0;
+        for (; done < budget && total > cap; ++done) {
+            auto oldest = mp.begin();
+            total -= weight_of((*oldest).second);
+            take(mp.extract(oldest));
+        }
+        return done;
+    }
+    void destroy(evicted e) { mp.destroy_node(e); }
+    void release(evicted e) { mp.deallocate_node(e); }
+    /**
+     * return a pointer contain the value
+     */
+    Value *get(const Key &key) { return get_key(key); }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    Value *get(const K &key) {
+        return get_key(key);
+    }
+    /**
+     * out[i] = get(keys[i]) for the n keys, the lookups of a batch are
+     * overlapped by linked_hashmap::find_many before any entry is used
+     */
+    void get_many(const Key *keys, size_t n, Value **out) {
+        get_many_keys(keys, n, out);
+    }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    void get_many(const K *keys, size_t n, Value **out) {
+        get_many_keys(keys, n, out);
+    }
+    using handle = typename lmap::Node *;
+    handle find(const Key &key) const { return mp.find_node(key); }
+    static Value &value_of(handle h) { return value_in(h->data.second); }
+    void touch(handle h) {
+        mp.touch(typename lmap::iterator(typename lmap::list_iterator(h)));
+    }
+    template <class K, class... Args>
+    pair<Value *, bool> try_emplace(K &&key, Args &&...args) {
+        auto res =
+            mp.try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+        if (!res.second) {
+            mp.touch(res.first);
+        } else {
+            weigh((*res.first).second);
+            if (!fit(res.first)) return pair<Value *, bool>(nullptr, true);
+        }
+        return pair<Value *, bool>(&value_in((*res.first).second), res.second);
+    }
+    /**
+     * try_emplace, but an existing value is replaced by value
+     */
+    template <class K, class V>
+    pair<Value *, bool> insert_or_assign(K &&key, V &&value) {
+        auto res = mp.try_emplace(std::forward<K>(key), std::forward<V>(value));
+        stored &slot = (*res.first).second;
+        if (!res.second) {
+            // value is untouched when the key existed
+            total -= weight_of(slot);
+            value_in(slot) = std::forward<V>(value);
+            mp.touch(res.first);
+        }
+        weigh(slot);
+        if (!fit(res.first)) return pair<Value *, bool>(nullptr, res.second);
+        return pair<Value *, bool>(&value_in(slot), res.second);
+    }
+    template <class F>
+    void for_each(F f) {
+        for (auto it = mp.begin(); it != mp.end(); ++it) {
+            f((*it).first, value_in((*it).second));
         }
-        /**
-         * iter--
-         */
-        iterator operator--(int) { 
-            iterator tmp = *this;
-            --list_iter; 
-            return tmp;
+    }
+
+   protected:
+    size_t cap;
+    size_t total;
+    size_t slack;
+    Weigher weigher;
+
+    template <class K>
+    Value *get_key(const K &key) {
+        // one probe, then the node is relinked in place: no copy
+        auto it = mp.touch(key);
+        if (it == mp.end()) return nullptr;
+        return &value_in(it->second);
+    }
+    template <class K>
+    void get_many_keys(const K *keys, size_t n, Value **out) {
+        const size_t batch = lmap::lookup_batch;
+        handle found[batch];
+        for (size_t i = 0; i < n; i += batch) {
+            size_t m = std::min(batch, n - i);
+            mp.find_nodes(keys + i, m, found);
+            for (size_t j = 0; j < m; ++j) {
+                out[i + j] = nullptr;
+                if (!found[j]) continue;
+                touch(found[j]);
+                out[i + j] = &value_of(found[j]);
+            }
         }
-        /**
-         * --iter
-         */
-        iterator &operator--() {
-            --list_iter;
-            return *this;
+    }
+    /**
+     * past capacity + slack, evict the oldest entries until the weights
+     * fit the capacity, return false if pos (the newest one) had to go
+     * as well
+     */
+    bool fit(typename lmap::iterator pos) {
+        if (total <= cap + slack) return true;
+        while (total > cap) {
+            auto oldest = mp.begin();
+            bool self = oldest == pos;
+            total -= weight_of((*oldest).second);
+            mp.remove(oldest);
+            if (self) return false;
+        }
+        return true;
+    }
+    static Value &value_in(stored &s) {
+        if constexpr (unit) {
+            return s;
+        } else {
+            return s.value;
+        }
+    }
+    static size_t weight_of(const stored &s) {
+        if constexpr (unit) {
+            return 1;
+        } else {
+            return s.meta;
         }
+    }
+    /**
+     * take the weight of a value just saved
+     */
+    void weigh(stored &s) {
+        if constexpr (!unit) s.meta = weigher(s.value);
+        total += weight_of(s);
+    }
+};
 
-        /**
-         * if the iter didn't point to a value
-         * throw "star invalid"
-         */
-        value_type &operator*() const {
-            if (list_iter.cur == nullptr) {
-                throw "star invalid";
+/**
+ * plain LRU, every entry weighs 1
+ */
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+class eviction<lru_policy, Key, Value, Hash, Equal, Alloc>
+    : public eviction<weighted_lru_policy<unit_weigher>, Key, Value, Hash,
+                      Equal, Alloc> {
+   public:
+    explicit eviction(size_t capacity)
+        : eviction<weighted_lru_policy<unit_weigher>, Key, Value, Hash, Equal,
+                   Alloc>(capacity) {}
+};
+
+/**
+ * what the policies other than lru_policy share: the entries live in a
+ * chained hashmap, every node sits in one double_list of the policy
+ * (which owns nothing, like the order list of linked_hashmap).
+ * Derived supplies
+ *   hit(node): key of node is used again
+ *   admit(node): link a new node, first evicting an entry if full()
+ * these policies are not copyable.
+ */
+template <class Derived, class Key, class Value, class Meta, class Hash,
+          class Equal, class Alloc>
+class eviction_base {
+   public:
+    using entry = cache_entry<Value, Meta>;
+    using value_type = sjtu::pair<const Key, entry>;
+    using map_type =
+        hashmap<Key, entry, Hash, Equal, chained_storage, prime_index,
+                alloc_for<Alloc, value_type> >;
+    using Node = typename map_type::Node;
+    using list_node = sjtu::Node<value_type>;
+    using list_type = double_list<value_type>;
+
+    explicit eviction_base(size_t capacity) : cap(capacity) {}
+    eviction_base(const eviction_base &) = delete;
+    eviction_base &operator=(const eviction_base &) = delete;
+
+    size_t size() const { return mp.size(); }
+    Value *get(const Key &key) { return get_key(key); }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    Value *get(const K &key) {
+        return get_key(key);
+    }
+    /**
+     * out[i] = get(keys[i]) for the n keys, see hashmap::find_many
+     */
+    void get_many(const Key *keys, size_t n, Value **out) {
+        get_many_keys(keys, n, out);
+    }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    void get_many(const K *keys, size_t n, Value **out) {
+        get_many_keys(keys, n, out);
+    }
+    using handle = Node *;
+    handle find(const Key &key) const { return mp.find_node(key); }
+    static Value &value_of(handle h) { return h->data.second.value; }
+    void touch(handle h) { self().hit(h); }
+    template <class K, class... Args>
+    pair<Value *, bool> try_emplace(K &&key, Args &&...args) {
+        bool inserted;
+        int idx;
+        Node *cur = mp.try_emplace_node(std::forward<K>(key), inserted, idx,
+                                        std::forward<Args>(args)...);
+        if (!inserted) {
+            self().hit(cur);
+            return pair<Value *, bool>(&cur->data.second.value, false);
+        }
+        if (cap == 0) {
+            mp.remove(cur->data.first);
+            return pair<Value *, bool>(nullptr, true);
+        }
+        self().admit(cur);
+        return pair<Value *, bool>(&cur->data.second.value, true);
+    }
+    template <class K, class V>
+    pair<Value *, bool> insert_or_assign(K &&key, V &&value) {
+        auto res = try_emplace(std::forward<K>(key), std::forward<V>(value));
+        // value is untouched when the key existed
+        if (!res.second) *res.first = std::forward<V>(value);
+        return res;
+    }
+
+   protected:
+    map_type mp;
+    size_t cap;
+
+    Derived &self() { return static_cast<Derived &>(*this); }
+    template <class K>
+    Value *get_key(const K &key) {
+        Node *cur = mp.find_node(key);
+        if (!cur) return nullptr;
+        self().hit(cur);
+        return &cur->data.second.value;
+    }
+    template <class K>
+    void get_many_keys(const K *keys, size_t n, Value **out) {
+        const size_t batch = map_type::lookup_batch;
+        Node *found[batch];
+        for (size_t i = 0; i < n; i += batch) {
+            size_t m = std::min(batch, n - i);
+            mp.find_nodes(keys + i, m, found);
+            for (size_t j = 0; j < m; ++j) {
+                out[i + j] = nullptr;
+                if (!found[j]) continue;
+                self().hit(found[j]);
+                out[i + j] = &found[j]->data.second.value;
             }
-            return *list_iter;
         }
-        value_type *operator->() const noexcept {
-            if (list_iter.cur == nullptr) {
-                throw "star invalid";
+    }
+    /**
+     * one entry too many, counting the one being admitted
+     */
+    bool full() const { return mp.size() > cap; }
+    static Meta &meta(list_node *node) { return node->data.second.meta; }
+    /**
+     * free a node already unlinked from the lists of the policy
+     */
+    void erase(list_node *node) { mp.remove(node->data.first); }
+    template <class F>
+    static void visit(list_type &list, F &f) {
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            f((*it).first, (*it).second.value);
+        }
+    }
+};
+
+/**
+ * the keys an ARC or 2Q cache remembers after evicting them,
+ * oldest first
+ */
+template <class Key, class Hash, class Equal, class Alloc>
+using ghost_list =
+    linked_hashmap<Key, char, Hash, Equal, chained_storage, prime_index,
+                   alloc_for<Alloc, pair<const Key, char> > >;
+
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+class eviction<clock_policy, Key, Value, Hash, Equal, Alloc>
+    : public eviction_base<
+          eviction<clock_policy, Key, Value, Hash, Equal, Alloc>, Key, Value,
+          bool, Hash, Equal, Alloc> {
+    using base = eviction_base<eviction, Key, Value, bool, Hash, Equal, Alloc>;
+    using list_node = typename base::list_node;
+    friend base;
+
+   public:
+    explicit eviction(size_t capacity) : base(capacity), hand(nullptr) {}
+    ~eviction() { ring.release(); }
+    template <class F>
+    void for_each(F f) {
+        list_node *cur = hand;
+        if (!cur) return;
+        do {
+            f(cur->data.first, cur->data.second.value);
+            cur = advance(cur);
+        } while (cur != hand);
+    }
+
+   private:
+    typename base::list_type ring;
+    // the entry the hand looks at next, nullptr if the ring is empty
+    list_node *hand;
+
+    list_node *advance(list_node *node) {
+        return node->next ? node->next : ring.begin().cur;
+    }
+    void hit(list_node *node) { base::meta(node) = true; }
+    /**
+     * the hand clears the bits it passes and takes the first entry
+     * without one, the new entry goes right behind the hand
+     */
+    void admit(list_node *node) {
+        if (this->full()) {
+            while (base::meta(hand)) {
+                base::meta(hand) = false;
+                hand = advance(hand);
             }
-            return &(*list_iter);
+            list_node *victim = hand;
+            hand = advance(hand);
+            if (hand == victim) hand = nullptr;
+            ring.unlink(victim);
+            this->erase(victim);
+        }
+        if (hand) {
+            ring.link_before(hand, node);
+        } else {
+            ring.link_tail(node);
+            hand = node;
         }
+    }
+};
 
-        /**
-         * operator to check whether two iterators are same (pointing to the
-         * same memory).
-         */
-        bool operator==(const iterator &rhs) const {
-            return list_iter == rhs.list_iter;
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+class eviction<slru_policy, Key, Value, Hash, Equal, Alloc>
+    : public eviction_base<
+          eviction<slru_policy, Key, Value, Hash, Equal, Alloc>, Key, Value,
+          bool, Hash, Equal, Alloc> {
+    using base = eviction_base<eviction, Key, Value, bool, Hash, Equal, Alloc>;
+    using list_node = typename base::list_node;
+    friend base;
+
+   public:
+    explicit eviction(size_t capacity)
+        : base(capacity), protected_count(0), protected_cap(capacity * 4 / 5) {}
+    ~eviction() {
+        probation_list.release();
+        protected_list.release();
+    }
+    template <class F>
+    void for_each(F f) {
+        base::visit(probation_list, f);
+        base::visit(protected_list, f);
+    }
+
+   private:
+    // meta: the entry is in the protected segment
+    typename base::list_type probation_list;
+    typename base::list_type protected_list;
+    size_t protected_count;
+    size_t protected_cap;
+
+    void hit(list_node *node) {
+        if (base::meta(node)) {
+            protected_list.move_to_tail(node);
+            return;
         }
-        bool operator!=(const iterator &rhs) const {
-            return list_iter != rhs.list_iter;
+        probation_list.unlink(node);
+        protected_list.link_tail(node);
+        base::meta(node) = true;
+        if (++protected_count > protected_cap) {
+            list_node *demoted = protected_list.begin().cur;
+            protected_list.unlink(demoted);
+            base::meta(demoted) = false;
+            probation_list.link_tail(demoted);
+            --protected_count;
         }
-        bool operator==(const const_iterator &rhs) const {
-            return list_iter == rhs.list_iter;
+    }
+    void admit(list_node *node) {
+        if (this->full()) {
+            list_node *victim;
+            if (!probation_list.empty()) {
+                victim = probation_list.begin().cur;
+                probation_list.unlink(victim);
+            } else {
+                victim = protected_list.begin().cur;
+                protected_list.unlink(victim);
+                --protected_count;
+            }
+            this->erase(victim);
         }
-        bool operator!=(const const_iterator &rhs) const {
-            return list_iter != rhs.list_iter;
+        probation_list.link_tail(node);
+    }
+};
+
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+class eviction<two_queue_policy, Key, Value, Hash, Equal, Alloc>
+    : public eviction_base<
+          eviction<two_queue_policy, Key, Value, Hash, Equal, Alloc>, Key,
+          Value, bool, Hash, Equal, Alloc> {
+    using base = eviction_base<eviction, Key, Value, bool, Hash, Equal, Alloc>;
+    using list_node = typename base::list_node;
+    using ghost_type = ghost_list<Key, Hash, Equal, Alloc>;
+    friend base;
+
+   public:
+    explicit eviction(size_t capacity)
+        : base(capacity),
+          in_count(0),
+          in_cap(std::max<size_t>(capacity / 4, 1)),
+          out_cap(std::max<size_t>(capacity / 2, 1)) {}
+    ~eviction() {
+        in_list.release();
+        main_list.release();
+    }
+    template <class F>
+    void for_each(F f) {
+        base::visit(in_list, f);
+        base::visit(main_list, f);
+    }
+
+   private:
+    // meta: the entry is in the main queue
+    typename base::list_type in_list;
+    typename base::list_type main_list;
+    ghost_type out_list;
+    size_t in_count;
+    size_t in_cap;
+    size_t out_cap;
+
+    /**
+     * a hit in the FIFO changes nothing, it may only be a burst
+     */
+    void hit(list_node *node) {
+        if (base::meta(node)) main_list.move_to_tail(node);
+    }
+    void admit(list_node *node) {
+        auto ghost = out_list.find(node->data.first);
+        bool seen = ghost != out_list.end();
+        if (seen) out_list.remove(ghost);
+        if (this->full()) {
+            list_node *victim;
+            if (in_count > in_cap || main_list.empty()) {
+                victim = in_list.begin().cur;
+                in_list.unlink(victim);
+                --in_count;
+                out_list.insert(typename ghost_type::value_type(victim->data.first, 0));
+                if (out_list.size() > out_cap) out_list.remove(out_list.begin());
+            } else {
+                victim = main_list.begin().cur;
+                main_list.unlink(victim);
+            }
+            this->erase(victim);
+        }
+        if (seen) {
+            main_list.link_tail(node);
+            base::meta(node) = true;
+        } else {
+            in_list.link_tail(node);
+            ++in_count;
+        }
+    }
+};
+
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+class eviction<arc_policy, Key, Value, Hash, Equal, Alloc>
+    : public eviction_base<
+          eviction<arc_policy, Key, Value, Hash, Equal, Alloc>, Key, Value,
+          bool, Hash, Equal, Alloc> {
+    using base = eviction_base<eviction, Key, Value, bool, Hash, Equal, Alloc>;
+    using list_node = typename base::list_node;
+    using ghost_type = ghost_list<Key, Hash, Equal, Alloc>;
+    friend base;
+
+   public:
+    explicit eviction(size_t capacity)
+        : base(capacity), t1_count(0), t2_count(0), target(0) {}
+    ~eviction() {
+        t1.release();
+        t2.release();
+    }
+    template <class F>
+    void for_each(F f) {
+        base::visit(t1, f);
+        base::visit(t2, f);
+    }
+
+   private:
+    // t1: entries used once, t2: used more than once, meta: in t2
+    // b1, b2: keys recently evicted from t1, t2
+    typename base::list_type t1;
+    typename base::list_type t2;
+    ghost_type b1;
+    ghost_type b2;
+    size_t t1_count;
+    size_t t2_count;
+    // the size t1 is aimed at
+    size_t target;
+
+    void hit(list_node *node) {
+        if (base::meta(node)) {
+            t2.move_to_tail(node);
+            return;
+        }
+        t1.unlink(node);
+        --t1_count;
+        t2.link_tail(node);
+        ++t2_count;
+        base::meta(node) = true;
+    }
+    /**
+     * evict the oldest entry of t1 or t2 into its ghost list
+     */
+    void replace(bool in_b2) {
+        list_node *victim;
+        if (t1_count > 0 && (t2_count == 0 || t1_count > target ||
+                             (in_b2 && t1_count == target))) {
+            victim = t1.begin().cur;
+            t1.unlink(victim);
+            --t1_count;
+            b1.insert(typename ghost_type::value_type(victim->data.first, 0));
+        } else {
+            victim = t2.begin().cur;
+            t2.unlink(victim);
+            --t2_count;
+            b2.insert(typename ghost_type::value_type(victim->data.first, 0));
+        }
+        this->erase(victim);
+    }
+    void admit(list_node *node) {
+        const size_t cap = this->cap;
+        auto ghost = b1.find(node->data.first);
+        if (ghost != b1.end()) {
+            target = std::min(cap, target + std::max<size_t>(b2.size() / b1.size(), 1));
+            b1.remove(ghost);
+            if (this->full()) replace(false);
+            link_frequent(node);
+            return;
+        }
+        ghost = b2.find(node->data.first);
+        if (ghost != b2.end()) {
+            size_t delta = std::max<size_t>(b1.size() / b2.size(), 1);
+            target = target > delta ? target - delta : 0;
+            b2.remove(ghost);
+            if (this->full()) replace(true);
+            link_frequent(node);
+            return;
+        }
+        if (t1_count + b1.size() >= cap) {
+            if (t1_count < cap) {
+                b1.remove(b1.begin());
+                if (this->full()) replace(false);
+            } else {
+                list_node *victim = t1.begin().cur;
+                t1.unlink(victim);
+                --t1_count;
+                this->erase(victim);
+            }
+        } else if (this->full()) {
+            if (t1_count + t2_count + b1.size() + b2.size() >= 2 * cap &&
+                !b2.empty())
+                b2.remove(b2.begin());
+            replace(false);
+        }
+        t1.link_tail(node);
+        ++t1_count;
+    }
+    void link_frequent(list_node *node) {
+        t2.link_tail(node);
+        ++t2_count;
+        base::meta(node) = true;
+    }
+};
+
+/**
+ * count-min sketch of 4-bit counters, the frequency estimate of
+ * w_tinylfu_policy. a hash value has a counter in each of depth rows,
+ * its estimate is the smallest of them. once sample_size increments
+ * are counted every counter is halved, so old popularity fades.
+ */
+class frequency_sketch {
+   public:
+    static const int depth = 4;
+
+    explicit frequency_sketch(size_t capacity)
+        : width(fibonacci_index::size(std::max<size_t>(capacity, 16))),
+          table(depth * width / 16, 0),
+          sample_size(10 * width),
+          additions(0) {}
+
+    void increment(size_t h) {
+        bool added = false;
+        size_t a = murmur_index::mix(h), b = (a >> 32) | 1;
+        for (int r = 0; r < depth; ++r) {
+            size_t i = counter(a, b, r);
+            unsigned long long &word = table[i >> 4];
+            int shift = (i & 15) * 4;
+            if (((word >> shift) & 15) != 15) {
+                word += 1ULL << shift;
+                added = true;
+            }
+        }
+        if (added && ++additions == sample_size) age();
+    }
+    int estimate(size_t h) const {
+        int freq = 15;
+        size_t a = murmur_index::mix(h), b = (a >> 32) | 1;
+        for (int r = 0; r < depth; ++r) {
+            size_t i = counter(a, b, r);
+            freq = std::min(freq, int(table[i >> 4] >> ((i & 15) * 4)) & 15);
+        }
+        return freq;
+    }
+
+   private:
+    // counters per row, a power of two
+    size_t width;
+    // 16 counters per word, row after row
+    std::vector<unsigned long long> table;
+    size_t sample_size;
+    size_t additions;
+
+    /**
+     * the counter of row r, rows are picked by double hashing
+     */
+    size_t counter(size_t a, size_t b, int r) const {
+        return r * width + ((a + r * b) & (width - 1));
+    }
+    void age() {
+        for (auto &word : table) word = (word >> 1) & 0x7777777777777777ULL;
+        additions /= 2;
+    }
+};
+
+/**
+ * W-TinyLFU: a new entry waits in a small LRU window (1% of the
+ * capacity), the one pushed out of it is only admitted into the main
+ * segmented LRU if the sketch says it is used more often than the entry
+ * it would evict there, otherwise the newcomer is dropped instead.
+ */
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+class eviction<w_tinylfu_policy, Key, Value, Hash, Equal, Alloc>
+    : public eviction_base<
+          eviction<w_tinylfu_policy, Key, Value, Hash, Equal, Alloc>, Key,
+          Value, char, Hash, Equal, Alloc> {
+    using base = eviction_base<eviction, Key, Value, char, Hash, Equal, Alloc>;
+    using list_node = typename base::list_node;
+    friend base;
+
+   public:
+    explicit eviction(size_t capacity)
+        : base(capacity),
+          sketch(capacity),
+          window_count(0),
+          window_cap(std::max<size_t>(capacity / 100, 1)),
+          main_count(0),
+          main_cap(capacity > window_cap ? capacity - window_cap : 0),
+          protected_count(0),
+          protected_cap(main_cap * 4 / 5) {}
+    ~eviction() {
+        window_list.release();
+        probation_list.release();
+        protected_list.release();
+    }
+    template <class F>
+    void for_each(F f) {
+        base::visit(window_list, f);
+        base::visit(probation_list, f);
+        base::visit(protected_list, f);
+    }
+
+   private:
+    // meta: the list holding the entry
+    enum { in_window, in_probation, in_protected };
+    typename base::list_type window_list;
+    typename base::list_type probation_list;
+    typename base::list_type protected_list;
+    frequency_sketch sketch;
+    Hash hash;
+    size_t window_count;
+    size_t window_cap;
+    size_t main_count;
+    size_t main_cap;
+    size_t protected_count;
+    size_t protected_cap;
+
+    size_t key_hash(list_node *node) const { return hash(node->data.first); }
+    void hit(list_node *node) {
+        sketch.increment(key_hash(node));
+        if (base::meta(node) == in_window) {
+            window_list.move_to_tail(node);
+        } else if (base::meta(node) == in_protected) {
+            protected_list.move_to_tail(node);
+        } else {
+            probation_list.unlink(node);
+            protected_list.link_tail(node);
+            base::meta(node) = in_protected;
+            if (++protected_count > protected_cap) {
+                list_node *demoted = protected_list.begin().cur;
+                protected_list.unlink(demoted);
+                base::meta(demoted) = in_probation;
+                probation_list.link_tail(demoted);
+                --protected_count;
+            }
+        }
+    }
+    void admit(list_node *node) {
+        sketch.increment(key_hash(node));
+        window_list.link_tail(node);
+        base::meta(node) = in_window;
+        if (++window_count <= window_cap) return;
+        list_node *candidate = window_list.begin().cur;
+        window_list.unlink(candidate);
+        --window_count;
+        if (main_count < main_cap) {
+            probation_list.link_tail(candidate);
+            base::meta(candidate) = in_probation;
+            ++main_count;
+            return;
+        }
+        list_node *victim = nullptr;
+        if (!probation_list.empty())
+            victim = probation_list.begin().cur;
+        else if (!protected_list.empty())
+            victim = protected_list.begin().cur;
+        if (!victim ||
+            sketch.estimate(key_hash(candidate)) <=
+                sketch.estimate(key_hash(victim))) {
+            this->erase(candidate);
+            return;
+        }
+        if (base::meta(victim) == in_protected) {
+            protected_list.unlink(victim);
+            --protected_count;
+        } else {
+            probation_list.unlink(victim);
+        }
+        this->erase(victim);
+        probation_list.link_tail(candidate);
+        base::meta(candidate) = in_probation;
+    }
+};
+
+/**
+ * a frequency of lfu_policy and its entries, oldest first
+ */
+template <class Key, class Value>
+class lfu_bucket;
+template <class Key, class Value>
+using lfu_value =
+    pair<const Key, cache_entry<Value, sjtu::Node<lfu_bucket<Key, Value> > *> >;
+template <class Key, class Value>
+class lfu_bucket {
+   public:
+    size_t freq;
+    double_list<lfu_value<Key, Value> > entries;
+    lfu_bucket(size_t freq) : freq(freq) {}
+};
+
+template <class Key, class Value, class Hash, class Equal, class Alloc>
+class eviction<lfu_policy, Key, Value, Hash, Equal, Alloc>
+    : public eviction_base<
+          eviction<lfu_policy, Key, Value, Hash, Equal, Alloc>, Key, Value,
+          sjtu::Node<lfu_bucket<Key, Value> > *, Hash, Equal, Alloc> {
+    using bucket = lfu_bucket<Key, Value>;
+    using bucket_node = sjtu::Node<bucket>;
+    using base =
+        eviction_base<eviction, Key, Value, bucket_node *, Hash, Equal, Alloc>;
+    using list_node = typename base::list_node;
+    using bucket_list = double_list<bucket, alloc_for<Alloc, bucket> >;
+    friend base;
+
+   public:
+    explicit eviction(size_t capacity) : base(capacity) {}
+    ~eviction() {
+        for (auto it = buckets.begin(); it != buckets.end(); ++it) {
+            (*it).entries.release();
+        }
+    }
+    template <class F>
+    void for_each(F f) {
+        for (auto it = buckets.begin(); it != buckets.end(); ++it) {
+            base::visit((*it).entries, f);
+        }
+    }
+
+   private:
+    // by increasing frequency, meta of an entry is its bucket
+    bucket_list buckets;
+
+    /**
+     * a new bucket of frequency freq right behind pos
+     * (at the head if pos is nullptr)
+     */
+    bucket_node *add_bucket(bucket_node *pos, size_t freq) {
+        if (!pos) {
+            buckets.insert_head(bucket(freq));
+            return buckets.begin().cur;
+        }
+        buckets.insert_tail(bucket(freq));
+        bucket_node *added = buckets.get_tail().cur;
+        if (pos->next != added) buckets.splice(pos->next, buckets, added);
+        return added;
+    }
+    void leave(list_node *node) {
+        bucket_node *from = base::meta(node);
+        from->data.entries.unlink(node);
+        if (from->data.entries.empty()) buckets.erase(from);
+    }
+    void hit(list_node *node) {
+        bucket_node *from = base::meta(node);
+        bucket_node *to = from->next;
+        if (!to || to->data.freq != from->data.freq + 1)
+            to = add_bucket(from, from->data.freq + 1);
+        leave(node);
+        to->data.entries.link_tail(node);
+        base::meta(node) = to;
+    }
+    void admit(list_node *node) {
+        if (this->full()) {
+            list_node *victim = buckets.begin().cur->data.entries.begin().cur;
+            leave(victim);
+            this->erase(victim);
+        }
+        bucket_node *first = buckets.begin().cur;
+        if (!first || first->data.freq != 1) first = add_bucket(nullptr, 1);
+        first->data.entries.link_tail(node);
+        base::meta(node) = first;
+    }
+};
+
+/**
+ * a cache holding at most size entries of Key -> Value,
+ * Policy chooses the entry to evict, by default the least
+ * recently saved or got one.
+ * Size is the type of the capacity.
+ * the nodes of the cache come from Alloc (rebound to each node type),
+ * by default a pool_allocator: an evicted node is reused by the next save.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key>, class Size = size_t,
+          class Policy = lru_policy,
+          class Alloc = pool_allocator<pair<const Key, Value> > >
+class basic_lru : public eviction<Policy, Key, Value, Hash, Equal, Alloc> {
+    using base = eviction<Policy, Key, Value, Hash, Equal, Alloc>;
+
+   public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = sjtu::pair<const Key, Value>;
+
+    basic_lru(Size size) : base(static_cast<size_t>(size)) {}
+    ~basic_lru() {}
+    Size capacity() const { return static_cast<Size>(this->cap); }
+    /**
+     * save the value_pair in the memory
+     * delete something in the memory if necessary
+     */
+    void save(const value_type &v) { save(v.first, v.second); }
+    void save(value_type &&v) { save(v.first, std::move(v.second)); }
+    /**
+     * the same, the value is forwarded into the cache
+     * (moved from an rvalue, copied from an lvalue)
+     */
+    template <class K, class V>
+    void save(K &&key, V &&value) {
+        this->insert_or_assign(std::forward<K>(key), std::forward<V>(value));
+    }
+    /**
+     * if key is not cached, build its value in place from args and
+     * delete something in the memory if necessary,
+     * otherwise only mark it as used, like get.
+     * return a pointer contain the value, nullptr if it was evicted
+     * right away (size is 0)
+     */
+    template <class K, class... Args>
+    Value *emplace(K &&key, Args &&...args) {
+        return this
+            ->try_emplace(std::forward<K>(key), std::forward<Args>(args)...)
+            .first;
+    }
+    /**
+     * the value of key, computed by loader(key) and saved if it is not
+     * cached. an exception of loader leaves the memory unchanged.
+     * return nullptr only if the new value was evicted right away
+     */
+    template <class Loader>
+    Value *get_or_load(const Key &key, Loader loader) {
+        Value *value = this->get(key);
+        if (value) return value;
+        return emplace(key, loader(key));
+    }
+    /**
+     * just print everything in the memory
+     * to debug or test.
+     * this operation follows the order, but don't
+     * change the order.
+     */
+    void print() {
+        this->for_each([](const Key &key, const Value &value) {
+            std::cout << key << " " << value << std::endl;
+        });
+    }
+};
+
+/**
+ * capacity split policies of concurrent_lru, shard_capacity(total, n, i)
+ * is the capacity of shard i out of n
+ * even_split: the shards add up to total exactly
+ * padded_split: every shard gets 1/8 more than its share, a shard
+ *   busier than average then evicts later, the cache may hold up to
+ *   total * 9/8 entries
+ */
+struct even_split {
+    static size_t shard_capacity(size_t total, size_t n, size_t i) {
+        return total / n + (i < total % n ? 1 : 0);
+    }
+};
+struct padded_split {
+    static size_t shard_capacity(size_t total, size_t n, size_t) {
+        size_t share = (total + n - 1) / n;
+        return share + share / 8;
+    }
+};
+
+/**
+ * the uses of cached entries seen by readers, for a writer to replay.
+ * a reader holding the shared lock of the cache reserves a slot of its
+ * stripe (picked by thread) with one compare-and-swap, a writer holding
+ * the exclusive lock drains every stripe. a full stripe drops the use:
+ * the order of the cache is only approximately LRU, which is the price
+ * of readers that never write to the list.
+ */
+template <class Handle>
+class read_buffer {
+   public:
+    static const int stripe_count = 4;
+    static const int stripe_size = 16;
+
+    read_buffer() {}
+    read_buffer(const read_buffer &) = delete;
+    read_buffer &operator=(const read_buffer &) = delete;
+
+    /**
+     * under the shared lock: remember a use of h,
+     * return false if the stripe is full and it was dropped
+     */
+    bool record(Handle h) {
+        stripe &s = parts[stripe_of()];
+        size_t t = s.tail.load(std::memory_order_relaxed);
+        do {
+            if (t - s.head >= stripe_size) return false;
+        } while (!s.tail.compare_exchange_weak(t, t + 1,
+                                               std::memory_order_relaxed));
+        // the slot is ours until the next drain, which waits for the
+        // shared lock to be released
+        s.slots[t & (stripe_size - 1)] = h;
+        return true;
+    }
+    /**
+     * under the exclusive lock: call f(h) on every use, oldest first
+     * in each stripe
+     */
+    template <class F>
+    void drain(F f) {
+        for (stripe &s : parts) {
+            size_t t = s.tail.load(std::memory_order_relaxed);
+            for (; s.head != t; ++s.head) f(s.slots[s.head & (stripe_size - 1)]);
         }
+    }
+
+   private:
+    struct alignas(64) stripe {
+        std::atomic<size_t> tail{0};
+        size_t head = 0;
+        Handle slots[stripe_size];
     };
+    stripe parts[stripe_count];
 
-    class const_iterator {
-       public:
-        typename double_list<value_type>::const_iterator list_iter;
-        /**
-         * elements
-         * add whatever you want
-         */
-        // --------------------------
-        const_iterator() {}
-        const_iterator(
-            const typename double_list<value_type>::const_iterator &it)
-            : list_iter(it) {}
-        const_iterator(const iterator &other) : list_iter(other.list_iter) {}
-        const_iterator(const const_iterator &other)
-            : list_iter(other.list_iter) {}
+    static size_t stripe_of() {
+        // a thread is known by the address of its own variable
+        static thread_local char tag;
+        return murmur_index::mix(reinterpret_cast<size_t>(&tag)) &
+               (stripe_count - 1);
+    }
+};
 
-        /**
-         * iter++
-         */
-        const_iterator operator++(int) {
-            const_iterator tmp(list_iter);
-            ++list_iter;
-            return tmp;
-        }
-        /**
-         * ++iter
-         */
-        const_iterator &operator++() {
-            ++list_iter;
-            return *this;
-        }
-        /**
-         * iter--
-         */
-        const_iterator operator--(int) {
-            const_iterator tmp(list_iter);
-            --list_iter;
-            return tmp;
-        }
-        /**
-         * --iter
-         */
-        const_iterator &operator--() {
-            --list_iter;
-            return *this;
+/**
+ * a basic_lru shared by threads: keys are spread over independent
+ * shards by their hash, each shard is a basic_lru with its own lock.
+ * a read only takes the shard lock shared: it looks the key up without
+ * touching the order of the cache and leaves the use in a read_buffer,
+ * the next write to the shard (or the reader finding the buffer full)
+ * replays the uses under the exclusive lock.
+ * reads are shared-lock reads, not lock-free ones: the map of a shard
+ * is a plain hashmap that a writer changes in place, so every reader
+ * still writes the lock word of its shard.
+ * a value is never handed out by pointer, another thread could evict
+ * it: get copies it, visit runs a function on it under the lock.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key>, class Size = size_t,
+          class Policy = lru_policy, class Split = even_split,
+          class Alloc = pool_allocator<pair<const Key, Value> > >
+class concurrent_lru {
+   public:
+    using value_type = sjtu::pair<const Key, Value>;
+    using shard_type =
+        basic_lru<Key, Value, Hash, Equal, size_t, Policy, Alloc>;
+
+    /**
+     * shards is rounded up to a power of two
+     */
+    concurrent_lru(Size size, size_t shards = 16) : shift(64) {
+        size_t n = fibonacci_index::size(std::max<size_t>(shards, 1));
+        for (size_t i = n; i > 1; i >>= 1) --shift;
+        for (size_t i = 0; i < n; ++i) {
+            parts.emplace_back(new shard(
+                Split::shard_capacity(static_cast<size_t>(size), n, i)));
         }
+    }
+    concurrent_lru(const concurrent_lru &) = delete;
+    concurrent_lru &operator=(const concurrent_lru &) = delete;
 
-        /**
-         * if the iter didn't point to a value
-         * throw
-         */
-        const value_type &operator*() const {
-            if (list_iter.cur == nullptr) {
-                throw "star invalid";
+    size_t shard_count() const { return parts.size(); }
+    /**
+     * the sum of the shards, each read under its lock
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (auto &p : parts) {
+            std::shared_lock<std::shared_mutex> guard(p->lock);
+            total += p->cache.size();
+        }
+        return total;
+    }
+    void save(const value_type &v) { save(v.first, v.second); }
+    void save(value_type &&v) { save(v.first, std::move(v.second)); }
+    template <class K, class V>
+    void save(K &&key, V &&value) {
+        shard &p = shard_of(key);
+        std::lock_guard<std::shared_mutex> guard(p.lock);
+        p.drain();
+        p.cache.save(std::forward<K>(key), std::forward<V>(value));
+    }
+    /**
+     * build the value of key in place if it is missing,
+     * return true if it was inserted
+     */
+    template <class K, class... Args>
+    bool emplace(K &&key, Args &&...args) {
+        shard &p = shard_of(key);
+        std::lock_guard<std::shared_mutex> guard(p.lock);
+        p.drain();
+        return p.cache
+            .try_emplace(std::forward<K>(key), std::forward<Args>(args)...)
+            .second;
+    }
+    /**
+     * copy the value of key into out, return false on a miss
+     */
+    bool get(const Key &key, Value &out) {
+        return visit(key, [&out](const Value &value) { out = value; });
+    }
+    /**
+     * the value of key, loading it with loader(key) on a miss.
+     * concurrent misses of a key run loader once: the first thread
+     * loads, the others wait for its result. the value is saved before
+     * any of them sees it, an exception of loader is thrown to all of
+     * them and nothing is saved.
+     * loader runs without any lock held, but must not ask for key again
+     */
+    template <class Loader>
+    Value get_or_load(const Key &key, Loader loader) {
+        Value out;
+        if (get(key, out)) return out;
+        shard &p = shard_of(key);
+        std::promise<Value> result;
+        std::shared_future<Value> flight;
+        {
+            std::lock_guard<std::shared_mutex> guard(p.lock);
+            p.drain();
+            if (Value *value = p.cache.get(key)) return *value;
+            auto it = p.loading.find(key);
+            if (it != p.loading.end()) {
+                flight = (*it).second;
+            } else {
+                p.loading.insert(typename flight_map::value_type(
+                    key, result.get_future().share()));
             }
-            return *list_iter;
         }
-        const value_type *operator->() const noexcept {
-            if (list_iter.cur == nullptr) {
-                throw "star invalid";
+        // someone else is loading it
+        if (flight.valid()) return flight.get();
+        try {
+            Value value = loader(key);
+            {
+                std::lock_guard<std::shared_mutex> guard(p.lock);
+                p.drain();
+                p.cache.save(key, value);
+                p.loading.remove(key);
             }
-            return &(*list_iter);
+            result.set_value(value);
+            return value;
+        } catch (...) {
+            {
+                std::lock_guard<std::shared_mutex> guard(p.lock);
+                p.loading.remove(key);
+            }
+            result.set_exception(std::current_exception());
+            throw;
         }
+    }
+    /**
+     * call f(value) under the lock of its shard, return false on a miss.
+     * other readers may be looking at the same value
+     */
+    template <class F>
+    bool visit(const Key &key, F f) {
+        shard &p = shard_of(key);
+        bool full;
+        {
+            std::shared_lock<std::shared_mutex> guard(p.lock);
+            handle h = p.cache.find(key);
+            if (!h) return false;
+            f(static_cast<const Value &>(shard_type::value_of(h)));
+            full = !p.uses.record(h);
+        }
+        // the use was dropped, replay the others unless a writer
+        // is about to
+        if (full && p.lock.try_lock()) {
+            p.drain();
+            p.lock.unlock();
+        }
+        return true;
+    }
+
+   private:
+    using handle = typename shard_type::handle;
+    using flight_map = hashmap<Key, std::shared_future<Value>, Hash, Equal>;
 
+    // a shard per cache line, so two locks never share one
+    struct alignas(64) shard {
+        mutable std::shared_mutex lock;
+        shard_type cache;
+        read_buffer<handle> uses;
+        // the keys get_or_load is loading, and where to wait for them
+        flight_map loading;
+        explicit shard(size_t capacity) : cache(capacity) {}
         /**
-         * operator to check whether two iterators are same (pointing to the
-         * same memory).
+         * under the exclusive lock, before anything is evicted:
+         * a handle in the buffer is only valid until then
          */
-        bool operator==(const iterator &rhs) const {
-            return list_iter == rhs.list_iter;
-        }
-        bool operator!=(const iterator &rhs) const {
-            return list_iter != rhs.list_iter;
-        }
-        bool operator==(const const_iterator &rhs) const {
-            return list_iter == rhs.list_iter;
-        }
-        bool operator!=(const const_iterator &rhs) const {
-            return list_iter != rhs.list_iter;
+        void drain() {
+            uses.drain([this](handle h) { cache.touch(h); });
         }
     };
 
-    linked_hashmap() : hashmap<Key, T, Hash, Equal>(), db() {}
-    linked_hashmap(const linked_hashmap &other)
-        : hashmap<Key, T, Hash, Equal>(), db() {
-        for (auto it = other.db.begin(); it != other.db.end(); ++it) {
-            this->insert(*it);
-        }
+    std::vector<std::unique_ptr<shard> > parts;
+    Hash hash;
+    int shift;
+
+    /**
+     * the top bits of the mixed hash pick the shard, the shard map
+     * takes its bucket from the whole hash
+     */
+    template <class K>
+    shard &shard_of(const K &key) {
+        if (parts.size() == 1) return *parts[0];
+        return *parts[murmur_index::mix(hash(key)) >> shift];
     }
-    ~linked_hashmap() {}
-    linked_hashmap &operator=(const linked_hashmap &other) {
-        if (this == &other) return *this;
-        this->clear();
-        for (auto it = other.db.begin(); it != other.db.end(); ++it) {
-            this->insert(*it);
+};
+
+/**
+ * hierarchical timing wheel: levels of 64 slots, a slot of level k
+ * covers 64^k ticks. an entry is put in the lowest level whose span
+ * reaches its deadline, when the time gets to that slot the entries
+ * move down a level, so every entry is touched O(levels) times and
+ * nothing is ever scanned. deadlines beyond the top level wait there
+ * and are put back until they come close.
+ * Entry is a list node whose data.second has deadline (in ticks),
+ * timer_prev, timer_next and timer_slot.
+ */
+template <class Entry>
+class timing_wheel {
+   public:
+    static const int levels = 4;
+    static const int slot_bits = 6;
+    static const int slot_count = 1 << slot_bits;
+
+    timing_wheel() : slots(), time(0), count(0), occupied(0) {}
+    timing_wheel(const timing_wheel &) = delete;
+    timing_wheel &operator=(const timing_wheel &) = delete;
+
+    size_t size() const { return count; }
+    void schedule(Entry *e) {
+        unsigned long long d = e->data.second.deadline;
+        int level = 0, slot;
+        if (d <= time) {
+            slot = time & (slot_count - 1);
+        } else {
+            unsigned long long delta = d - time;
+            while (level < levels - 1 &&
+                   delta >= 1ULL << (slot_bits * (level + 1)))
+                ++level;
+            slot = (d >> (slot_bits * level)) & (slot_count - 1);
         }
-        return *this;
+        link(e, level * slot_count + slot);
     }
-
     /**
-     * return the value connected with the Key(O(1))
-     * if the key not found, throw
+     * take e out of the wheel, if it is in
      */
-    T &at(const Key &key) {
-        int idx = this->hash(key) % this->buckets.size();
-        Node *src = this->buckets[idx];
-        while (src) {
-            if (this->equal(src->data.first, key)) {
-                return src->data.second;
-            }
-            src = src->next;
-        }
-        throw "invalid";
+    void cancel(Entry *e) {
+        if (e->data.second.timer_slot >= 0) unlink(e);
     }
-    const T &at(const Key &key) const {
-        int idx = this->hash(key) % this->buckets.size();
-        Node *src = this->buckets[idx];
-        while (src) {
-            if (this->equal(src->data.first, key)) {
-                return src->data.second;
+    /**
+     * move the time up to now, calling expire(e) on every entry due
+     * (already out of the wheel), at most budget of them.
+     * return how many expired, if that is budget the time may
+     * not have reached now yet
+     */
+    template <class F>
+    size_t advance(unsigned long long now, size_t budget, F expire) {
+        size_t done = 0;
+        if (count == 0 && time <= now) time = now + 1;
+        while (time <= now) {
+            int slot = time & (slot_count - 1);
+            while (Entry *e = slots[0][slot]) {
+                if (done == budget) return done;
+                unlink(e);
+                expire(e);
+                ++done;
             }
-            src = src->next;
+            // skip to the next busy slot of this round, or the next round
+            unsigned long long next = (time | (slot_count - 1)) + 1;
+            if (slot + 1 < slot_count) {
+                unsigned long long rest = occupied >> (slot + 1);
+                if (rest) next = time + 1 + lowest_bit(rest);
+            }
+            time = std::min(next, now + 1);
+            if ((time & (slot_count - 1)) == 0) cascade();
         }
-        throw "invalid";
+        return done;
     }
-    T &operator[](const Key &key) {
-        int idx = this->hash(key) % this->buckets.size();
-        Node *src = this->buckets[idx];
-        while (src) {
-            if (this->equal(src->data.first, key)) {
-                return src->data.second;
-            }
-            src = src->next;
+
+   private:
+    Entry *slots[levels][slot_count];
+    // the next tick to be processed
+    unsigned long long time;
+    size_t count;
+    // the busy slots of level 0
+    unsigned long long occupied;
+
+    static int lowest_bit(unsigned long long bits) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(bits);
+#else
+        int i = 0;
+        while (!(bits & 1u)) {
+            bits >>= 1;
+            ++i;
         }
-        throw "invalid";
+        return i;
+#endif
     }
-    const T &operator[](const Key &key) const {
-        int idx = this->hash(key) % this->buckets.size();
-        Node *src = this->buckets[idx];
-        while (src) {
-            if (this->equal(src->data.first, key)) {
-                return src->data.second;
+    /**
+     * at a round boundary the slots of the upper levels that start
+     * now are spread down, the top one first
+     */
+    void cascade() {
+        int top = 1;
+        while (top < levels - 1 &&
+               (time & ((1ULL << (slot_bits * (top + 1))) - 1)) == 0)
+            ++top;
+        for (int level = top; level >= 1; --level) {
+            int slot = (time >> (slot_bits * level)) & (slot_count - 1);
+            Entry *e = slots[level][slot];
+            slots[level][slot] = nullptr;
+            while (e) {
+                Entry *next = e->data.second.timer_next;
+                e->data.second.timer_slot = -1;
+                --count;
+                schedule(e);
+                e = next;
             }
-            src = src->next;
         }
-        throw "invalid";
     }
+    /**
+     * slot at of level at / slot_count
+     */
+    Entry *&slot_head(int at) {
+        return slots[at >> slot_bits][at & (slot_count - 1)];
+    }
+    void link(Entry *e, int at) {
+        auto &t = e->data.second;
+        Entry *&head = slot_head(at);
+        t.timer_slot = at;
+        t.timer_prev = nullptr;
+        t.timer_next = head;
+        if (head) head->data.second.timer_prev = e;
+        head = e;
+        if (at < slot_count) occupied |= 1ULL << at;
+        ++count;
+    }
+    void unlink(Entry *e) {
+        auto &t = e->data.second;
+        Entry *&head = slot_head(t.timer_slot);
+        if (t.timer_prev)
+            t.timer_prev->data.second.timer_next = t.timer_next;
+        else
+            head = t.timer_next;
+        if (t.timer_next) t.timer_next->data.second.timer_prev = t.timer_prev;
+        if (!head && t.timer_slot < slot_count)
+            occupied &= ~(1ULL << t.timer_slot);
+        t.timer_prev = t.timer_next = nullptr;
+        t.timer_slot = -1;
+        --count;
+    }
+};
+
+/**
+ * the value of an expiring_lru entry and its timer, deadlines are
+ * ticks of the cache, never when there is none
+ */
+template <class Key, class Value>
+class timed_entry {
+   public:
+    using node = sjtu::Node<pair<const Key, timed_entry> >;
+    static constexpr unsigned long long never = ~0ULL;
+
+    Value value;
+    // the earlier of write_deadline and the last access + idle
+    unsigned long long deadline;
+    unsigned long long write_deadline;
+    // time to idle in ticks, 0 if none
+    unsigned long long idle;
+    node *timer_prev;
+    node *timer_next;
+    int timer_slot;
+
+    template <class... Args>
+    timed_entry(Args &&...args)
+        : value(std::forward<Args>(args)...),
+          deadline(never),
+          write_deadline(never),
+          idle(0),
+          timer_prev(nullptr),
+          timer_next(nullptr),
+          timer_slot(-1) {}
+};
+
+/**
+ * an LRU cache whose entries also expire:
+ * time to live, counted from the last save of the entry, and
+ * time to idle, counted from its last save or get.
+ * both have a default for the cache and can be given per save,
+ * zero means never. an expired entry is a miss for get at once,
+ * its memory is reclaimed a few entries per save/get or by cleanup().
+ * time is read from Clock and kept in ticks of resolution.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>,
+          class Equal = std::equal_to<Key>, class Size = size_t,
+          class Clock = std::chrono::steady_clock,
+          class Alloc = pool_allocator<pair<const Key, Value> > >
+class expiring_lru {
+   public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = sjtu::pair<const Key, Value>;
+    using duration = typename Clock::duration;
+    using entry = timed_entry<Key, Value>;
+    using lmap = sjtu::linked_hashmap<
+        Key, entry, Hash, Equal, sjtu::chained_storage, sjtu::prime_index,
+        alloc_for<Alloc, sjtu::pair<const Key, entry> > >;
+    // expired entries reclaimed by every save and get
+    static const size_t maintenance_budget = 4;
 
+    lmap mp;
+
+    expiring_lru(Size size, duration ttl = duration::zero(),
+                 duration tti = duration::zero(),
+                 duration resolution = std::chrono::milliseconds(1))
+        : cap(static_cast<size_t>(size)),
+          slack(0),
+          resolution(resolution),
+          start(Clock::now()),
+          default_ttl(ttl),
+          default_tti(tti) {}
+    expiring_lru(const expiring_lru &) = delete;
+    expiring_lru &operator=(const expiring_lru &) = delete;
+
+    size_t size() const { return mp.size(); }
+    Size capacity() const { return static_cast<Size>(cap); }
+    void set_ttl(duration ttl) { default_ttl = ttl; }
+    void set_tti(duration tti) { default_tti = tti; }
     /**
-     * return an iterator point to the first
-     * inserted and existed element
+     * leave the expired entries to trim, and the entries above
+     * capacity too as long as there are at most slack of them.
+     * get still never returns an expired value
      */
-    iterator begin() { return iterator(db.begin()); }
-    const_iterator cbegin() const { return const_iterator(db.begin()); }
+    void set_slack(size_t s) { slack = s; }
     /**
-     * return an iterator after the last inserted element
+     * trim has something to evict, not counting the expired entries
      */
-    iterator end() { return iterator(db.end()); }
-    const_iterator cend() const { return const_iterator(db.end()); }
+    bool over() const { return mp.size() > cap; }
     /**
-     * if didn't contain anything, return true,
-     * otherwise false.
+     * reclaim at most budget entries, the expired ones first, then the
+     * oldest ones until the size fits the capacity, return how many.
+     * the entries are handed to take, like basic_lru::trim
      */
-    bool empty() const {
-        if (db.empty()) return true;
-        return false;
+    using evicted = typename lmap::Node *;
+    template <class F>
+    size_t trim(size_t budget, F take) {
+        size_t done = wheel.advance(tick(), budget, [this, &take](node *e) {
+            take(extract(e));
+        });
+        for (; done < budget && mp.size() > cap; ++done) {
+            node *oldest = mp.begin().list_iter.cur;
+            wheel.cancel(oldest);
+            take(extract(oldest));
+        }
+        return done;
     }
-
-    void clear() {
-        hashmap<Key, T, Hash, Equal>::clear();
-        db.clear();
+    void destroy(evicted e) { mp.destroy_node(e); }
+    void release(evicted e) { mp.deallocate_node(e); }
+    /**
+     * save the value_pair in the memory with the default ttl and tti
+     * delete something in the memory if necessary
+     */
+    void save(const value_type &v) { save(v.first, v.second); }
+    void save(value_type &&v) { save(v.first, std::move(v.second)); }
+    template <class K, class V>
+    void save(K &&key, V &&value) {
+        save(std::forward<K>(key), std::forward<V>(value), default_ttl,
+             default_tti);
     }
-
-    size_t size() const { return this->num_elem; }
     /**
-     * insert the value_piar
-     * if the key of the value_pair exists in the map
-     * update the value instead of adding a new element，
-     * then the order of the element moved from inner of the
-     * list to the head of the list
-     * and return false
-     * if the key of the value_pair doesn't exist in the map
-     * add a new element and return true
+     * the same, with the ttl and tti of this entry
      */
-    pair<iterator, bool> insert(const value_type &value) {
-        Key key = value.first;
-        int idx = this->hash(key) % this->buckets.size();
-        Node *cur = this->buckets[idx];
-        bool flag = true;
-        while (cur) {
-            if (this->equal(key, cur->data.first)) {
-                flag = false;
-                cur->data.second = value.second;
-                db.erase(cur->list_iter);
-                db.insert_tail(value);
-                cur->list_iter = db.get_tail();
-                auto it = iterator(cur->list_iter);
-                return sjtu::pair<iterator, bool>(it, flag);
-            } else {
-                cur = cur->next;
-            }
+    template <class K, class V>
+    void save(K &&key, V &&value, duration ttl,
+              duration tti = duration::zero()) {
+        unsigned long long now = maintain();
+        auto res = mp.try_emplace(std::forward<K>(key), std::forward<V>(value));
+        node *cur = res.first.list_iter.cur;
+        entry &e = cur->data.second;
+        if (!res.second) {
+            // value is untouched when the key existed
+            e.value = std::forward<V>(value);
+            mp.touch(res.first);
         }
-        Node *newnode = new Node(value);
-        newnode->next = this->buckets[idx];
-        this->buckets[idx] = newnode;
-        db.insert_tail(value);
-        newnode->list_iter = db.get_tail();
-        this->num_elem++;
-        if (this->num_elem > this->buckets.size() * 0.75) {
-            this->expand();
+        e.write_deadline =
+            ttl == duration::zero() ? entry::never : now + ticks(ttl);
+        e.idle = tti == duration::zero() ? 0 : ticks(tti);
+        reschedule(cur, now);
+        if (mp.size() > cap + slack) {
+            while (mp.size() > cap) expire(mp.begin().list_iter.cur);
         }
-        auto it = iterator(newnode->list_iter);
-        return sjtu::pair<iterator, bool>(it, flag);
     }
     /**
-     * erase the value_pair pointed by the iterator
-     * if the iterator points to nothing
-     * throw
+     * return a pointer contain the value,
+     * nullptr if it is not cached or expired
      */
-    void remove(iterator pos) {
-        if (pos == end()) throw "iterator invalid";
-        Key key = pos.list_iter.cur->data.first;
-        hashmap<Key, T, Hash, Equal>::remove(key);
-        db.erase(pos.list_iter);
+    Value *get(const Key &key) { return get_key(key); }
+    template <class K, class = transparent_key<Hash, Equal, K> >
+    Value *get(const K &key) {
+        return get_key(key);
     }
     /**
-     * return how many value_pairs consist of key
-     * this should only return 0 or 1
+     * reclaim at most budget expired entries, return how many
      */
-    size_t count(const Key &key) const {
-        int idx = this->hash(key) % this->buckets.size();
-        Node *src = this->buckets[idx];
-        while (src) {
-            if (this->equal(src->data.first, key)) return 1;
-            src = src->next;
+    size_t cleanup(size_t budget = ~size_t(0)) {
+        return wheel.advance(tick(), budget, [this](node *e) { remove(e); });
+    }
+    /**
+     * just print everything in the memory, expired entries included
+     * to debug or test.
+     * this operation follows the order, but don't
+     * change the order.
+     */
+    void print() {
+        for (auto it = mp.begin(); it != mp.end(); ++it) {
+            std::cout << (*it).first << " " << (*it).second.value << std::endl;
+        }
+    }
+
+   private:
+    using node = typename entry::node;
+
+    size_t cap;
+    size_t slack;
+    duration resolution;
+    typename Clock::time_point start;
+    duration default_ttl;
+    duration default_tti;
+    timing_wheel<node> wheel;
+
+    unsigned long long tick() const {
+        return static_cast<unsigned long long>((Clock::now() - start) /
+                                               resolution);
+    }
+    /**
+     * a duration in ticks, rounded up
+     */
+    unsigned long long ticks(duration d) const {
+        return static_cast<unsigned long long>((d + resolution - duration(1)) /
+                                               resolution);
+    }
+    unsigned long long maintain() {
+        unsigned long long now = tick();
+        if (slack == 0) {
+            wheel.advance(now, maintenance_budget,
+                          [this](node *e) { remove(e); });
         }
-        return 0;
+        return now;
+    }
+    void reschedule(node *cur, unsigned long long now) {
+        entry &e = cur->data.second;
+        e.deadline = e.write_deadline;
+        if (e.idle) e.deadline = std::min(e.deadline, now + e.idle);
+        wheel.cancel(cur);
+        if (e.deadline != entry::never) wheel.schedule(cur);
     }
     /**
-     * find the iterator points at the value_pair
-     * which consist of key
-     * if not find, return the iterator
-     * point at nothing
+     * drop an entry that is out of the wheel
      */
-    iterator find(const Key &key) {
-        int idx = this->hash(key) % this->buckets.size();
-        Node *src = this->buckets[idx];
-        while (src) {
-            if (this->equal(src->data.first, key))
-                return iterator(src->list_iter);
-            src = src->next;
+    void remove(node *cur) {
+        mp.remove(typename lmap::iterator(typename lmap::list_iterator(cur)));
+    }
+    evicted extract(node *cur) {
+        return mp.extract(
+            typename lmap::iterator(typename lmap::list_iterator(cur)));
+    }
+    void expire(node *cur) {
+        wheel.cancel(cur);
+        remove(cur);
+    }
+    template <class K>
+    Value *get_key(const K &key) {
+        unsigned long long now = maintain();
+        auto it = mp.find(key);
+        if (it == mp.end()) return nullptr;
+        node *cur = it.list_iter.cur;
+        if (cur->data.second.deadline <= now) {
+            expire(cur);
+            return nullptr;
         }
-        return db.end();
+        mp.touch(it);
+        if (cur->data.second.idle) reschedule(cur, now);
+        return &cur->data.second.value;
     }
 };
 
-class lru {
-    using lmap = sjtu::linked_hashmap<Integer, Matrix<int>, Hash, Equal>;
-    using value_type = sjtu::pair<const Integer, Matrix<int> >;
-
+/**
+ * a cache whose evictions and expiry run on a background thread.
+ * save only links the new entry: the thread trims the cache back to
+ * its capacity and runs the destructors of the evicted entries outside
+ * of the lock, so a big destructor is never paid on the path of a save. the cache
+ * goes over capacity by at most slack, past that a save evicts inline.
+ * Cache is a basic_lru with lru_policy or weighted_lru_policy, or an
+ * expiring_lru, which the thread also clears of expired entries every
+ * interval.
+ */
+template <class Cache>
+class maintained_lru {
    public:
-   lmap mp;
-   int size;
+    using key_type = typename Cache::key_type;
+    using mapped_type = typename Cache::mapped_type;
+    using value_type = typename Cache::value_type;
+    // values evicted under the lock at once
+    static constexpr size_t batch = 64;
+
+    /**
+     * args are the constructor arguments of Cache
+     */
+    template <class... Args>
+    maintained_lru(size_t slack, std::chrono::milliseconds interval,
+                   Args &&...args)
+        : cache(std::forward<Args>(args)...),
+          interval(interval),
+          dirty(false),
+          stopping(false) {
+        cache.set_slack(slack);
+        worker = std::thread([this]() { work(); });
+    }
+    maintained_lru(const maintained_lru &) = delete;
+    maintained_lru &operator=(const maintained_lru &) = delete;
+    ~maintained_lru() { join(); }
 
-    lru(int size) :size(size) {
+    size_t size() {
+        std::lock_guard<std::mutex> guard(lock);
+        return cache.size();
+    }
+    template <class K, class V>
+    void save(K &&key, V &&value) {
+        std::lock_guard<std::mutex> guard(lock);
+        cache.save(std::forward<K>(key), std::forward<V>(value));
+        if (!dirty && cache.over()) {
+            dirty = true;
+            wake.notify_one();
+        }
     }
-    ~lru() {}
     /**
-     * save the value_pair in the memory
-     * delete something in the memory if necessary
+     * copy the value of key into out, return false on a miss
      */
-    void save(const value_type &v)  {
-        auto res = mp.insert(v);
-        if(!res.second){
-        }else{
-            if(mp.size()>size){
-                auto tail_it = mp.begin();
-                mp.remove(tail_it);
-            }
+    bool get(const key_type &key, mapped_type &out) {
+        return visit(key, [&out](mapped_type &value) { out = value; });
+    }
+    /**
+     * call f(value) under the lock, return false on a miss
+     */
+    template <class F>
+    bool visit(const key_type &key, F f) {
+        std::lock_guard<std::mutex> guard(lock);
+        mapped_type *value = cache.get(key);
+        if (!value) return false;
+        f(*value);
+        return true;
+    }
+    /**
+     * do all the pending maintenance on this thread, now
+     */
+    void sync() {
+        while (trim_batch()) {
         }
     }
     /**
-     * return a pointer contain the value
+     * stop the thread and wait for it, after a last full trim.
+     * from then on every save evicts inline
      */
-    Matrix<int> *get(const Integer &v) {
-        auto it = mp.find(v);
-        if(it==mp.end()) return nullptr;
-            else{
-                auto val = it->second;
-                mp.remove(it);
-                mp.insert({v,val});
-            }
-        return &(mp.at(v));
+    void join() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (stopping) return;
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+        sync();
+        std::lock_guard<std::mutex> guard(lock);
+        cache.set_slack(0);
     }
+
+   private:
+    Cache cache;
+    std::chrono::milliseconds interval;
+    std::mutex lock;
+    std::condition_variable wake;
+    bool dirty;
+    bool stopping;
+    std::thread worker;
+
     /**
-     * just print everything in the memory
-     * to debug or test.
-     * this operation follows the order, but don't
-     * change the order.
+     * evict one batch and run its destructors with the lock released,
+     * return false if there was nothing left to do
      */
-    void print() {
-        lmap::iterator it;
-        for(it = mp.begin(); it!=mp.end();++it){
-            std::cout<<(*it).first.val<<" "<<(*it).second<<std::endl;
+    bool trim_batch() {
+        std::vector<typename Cache::evicted> evicted;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            cache.trim(batch, [&evicted](typename Cache::evicted e) {
+                evicted.push_back(e);
+            });
+            if (evicted.empty()) {
+                dirty = false;
+                return false;
+            }
+        }
+        for (auto e : evicted) cache.destroy(e);
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto e : evicted) cache.release(e);
+        return true;
+    }
+    void work() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (!stopping) {
+            wake.wait_for(guard, interval, [this]() { return dirty || stopping; });
+            if (stopping) break;
+            guard.unlock();
+            sync();
+            guard.lock();
         }
     }
 };
+
+/**
+ * the cache of the tests
+ */
+using lru = basic_lru<Integer, Matrix<int>, ::Hash, ::Equal, int>;
 }  // namespace sjtu
 
 #endif
\ No newline at end of file
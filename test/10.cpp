@@ -0,0 +1,186 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: incremental insert & expand",
+    "test2: incremental remove",
+    "test3: incremental find during migration",
+    "test4: incremental constructor(), = during migration",
+    "test5: incremental clear",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+    "test6: incremental linked_hashmap order",
+    "test7: incremental migration by reads only",
+};
+
+template<class mp>
+bool check(mp &map,int n,int removed){
+    for(int i=0;i<n;i++){
+        typename mp::iterator it = map.find(Integer(i));
+        if(i<removed && i%3==0){
+            if(it != map.end()) return false;
+        }
+        else if (i % 4 == 0){
+            if(it == map.end() || (*it).second.val != 4 * i) return false;
+        }
+        else{
+            if(it == map.end() || (*it).second.val != i) return false;
+        }
+    }
+    return true;
+}
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+void incremental_hashmap_tester(){
+    using value_type = sjtu::pair<Integer,Integer>;
+    using mp = sjtu::hashmap<Integer,Integer,Hash,Equal,sjtu::incremental_storage>;
+    const int n = 100000;
+    mp map;
+
+    //test: insert and expand
+    if(STATUS)std::cout<<c[2];
+    int migrations = 0;
+    for(int i=0;i<n;i++){
+        map.insert(value_type(Integer(i),Integer(i % 4 ? i : 4 * i)));
+        if(map.migrate_pos == 0 && !map.old_buckets.empty()) migrations++;
+    }
+    std::cout<<migrations<<" "<<map.buckets.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+
+    //test: remove while the buckets are moving
+    if(STATUS)std::cout<<c[3];
+    while(map.old_buckets.empty()){
+        map.insert(value_type(Integer(map.num_elem),Integer(map.num_elem % 4 ? map.num_elem : 4 * map.num_elem)));
+    }
+    int m = map.num_elem;
+    for(int i=0;i<m;i+=3){
+        if(!map.remove(Integer(i))) fail();
+        if(i<60 && map.old_buckets.empty()) fail();
+    }
+    if(map.remove(Integer(0))) fail();
+    std::cout<<map.num_elem<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+
+    //test: constructor(), = in the middle of a migration
+    if(STATUS)std::cout<<c[5];
+    int removed = m;
+    while(map.old_buckets.empty()){
+        map.insert(value_type(Integer(m),Integer(m % 4 ? m : 4 * m)));
+        m++;
+    }
+    mp map2(map);
+    mp map3;
+    map3 = map;
+    if(map2.old_buckets.empty() || !check(map2,m,removed) || !check(map3,m,removed)) fail();
+    if(!check(map,m,removed) || !map.old_buckets.empty()) fail();
+    if(STATUS)std::cout<<c[0]<<std::endl;
+
+    //test: clear
+    if(STATUS)std::cout<<c[6];
+    map2.clear();
+    map2.clear();
+    if(map2.find(Integer(1)) != map2.end() || !map2.old_buckets.empty()) fail();
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void incremental_linked_hashmap_tester(){
+    using value_type = sjtu::pair<Integer,Integer>;
+    using mp = sjtu::linked_hashmap<Integer,Integer,Hash,Equal,sjtu::incremental_storage>;
+    const int n = 1000;
+    if(STATUS)std::cout<<c[8];
+    mp map;
+    for(int i=0;i<n;i++){
+        map.insert(value_type(Integer(i),Integer(i)));
+    }
+    for(int i=0;i<n;i+=4){
+        map.insert(value_type(Integer(i),Integer(4*i)));
+    }
+    for(mp::iterator it = map.begin();it!=map.end();){
+        mp::iterator tmpit = it;
+        it++;
+        if((*tmpit).first.val % 3 == 0) map.remove(tmpit);
+    }
+    mp map2(map);
+    std::cout<<map2.size()<<" "<<map2.count(Integer(4))<<" "<<map2.count(Integer(3))<<std::endl;
+    int shown = 0;
+    for(mp::const_iterator it = map2.cbegin();it!=map2.cend() && shown<40;++it,++shown){
+        std::cout<<(*it).first.val<<" "<<(*it).second.val<<std::endl;
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// grow past 1000 keys, until a migration has just started
+template<class mp>
+void start_migration(mp &map, int &n){
+    using value_type = sjtu::pair<Integer,Integer>;
+    while(n < 1000 || map.old_buckets.empty() || map.migrate_pos != 0){
+        map.insert(value_type(Integer(n),Integer(n)));
+        n++;
+    }
+}
+
+void read_migration_tester(){
+    using linked = sjtu::linked_hashmap<Integer,Integer,Hash,Equal,sjtu::incremental_storage>;
+    using plain = sjtu::hashmap<Integer,Integer,Hash,Equal,sjtu::incremental_storage>;
+    if(STATUS)std::cout<<c[9];
+    linked map;
+    int n = 0;
+    start_migration(map, n);
+    // const reads leave the migration alone
+    const linked &view = map;
+    for(int i=0;i<n;i++){
+        if(view.at(Integer(i)).val != i || view.count(Integer(i)) != 1) fail();
+    }
+    if(map.migrate_pos != 0 || map.old_buckets.empty()) fail();
+    // non-const reads finish it, a few buckets each
+    size_t steps = (map.old_buckets.size() + linked::migrate_batch - 1) / linked::migrate_batch;
+    size_t reads = 0;
+    while(!map.old_buckets.empty()){
+        if(reads % 2 ? map[Integer(reads % n)].val != int(reads % n)
+                     : map.at(Integer(reads % n)).val != int(reads % n)) fail();
+        reads++;
+        if(reads > steps) fail();
+    }
+    std::cout<<n<<" "<<reads<<std::endl;
+    plain map2;
+    int n2 = 0;
+    start_migration(map2, n2);
+    std::vector<Integer> keys;
+    plain::iterator found[10];
+    reads = 0;
+    while(!map2.old_buckets.empty()){
+        keys.clear();
+        for(int j=0;j<10;j++) keys.push_back(Integer((reads*10+j) % n2));
+        map2.find_many(keys.data(), 10, found);
+        for(int j=0;j<10;j++){
+            if(found[j] == map2.end() || (*found[j]).second.val != keys[j].val) fail();
+        }
+        reads++;
+    }
+    std::cout<<n2<<" "<<reads<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("10.out","w",stdout);
+#endif
+    incremental_hashmap_tester();
+    incremental_linked_hashmap_tester();
+    read_migration_tester();
+    std::cout << c[7] << std::endl;
+}
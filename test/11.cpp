@@ -0,0 +1,78 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: mod_index",
+    "test2: fibonacci_index",
+    "test3: murmur_index",
+    "test4: prime_index",
+    "test5: incremental prime_index",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+template<class Index, class Storage = sjtu::chained_storage>
+void index_tester(int title, int step){
+    using value_type = sjtu::pair<int,int>;
+    using mp = sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,Storage,Index>;
+    const int n = 50000;
+    if(STATUS)std::cout<<c[title];
+    mp map;
+    for(int i=0;i<n;i++){
+        map.insert(value_type(i*step,i));
+    }
+    for(int i=0;i<n;i+=3){
+        map.remove(i*step);
+    }
+    mp map2(map);
+    int found = 0;
+    for(int i=0;i<n;i++){
+        typename mp::iterator it = map2.find(i*step);
+        if(i%3==0){
+            if(it != map2.end()){
+                std::cout<<c[1]<<std::endl;
+                exit(0);
+            }
+        }
+        else{
+            if(it == map2.end() || (*it).second != i){
+                std::cout<<c[1]<<std::endl;
+                exit(0);
+            }
+            found++;
+        }
+    }
+    // a policy that spreads the keys keeps every chain short
+    size_t longest = 0;
+    for(size_t b=0;b<map2.buckets.size();b++){
+        size_t len = 0;
+        for(auto *p = map2.buckets[b];p;p = p->chain) len++;
+        if(len > longest) longest = len;
+    }
+    std::cout<<found<<" "<<map2.num_elem<<" "<<(longest < 16)<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("11.out","w",stdout);
+#endif
+    index_tester<sjtu::mod_index>(2,1);
+    index_tester<sjtu::fibonacci_index>(3,1);
+    index_tester<sjtu::fibonacci_index>(3,1024);
+    index_tester<sjtu::murmur_index>(4,1);
+    index_tester<sjtu::murmur_index>(4,1024);
+    index_tester<sjtu::prime_index>(5,1);
+    index_tester<sjtu::prime_index>(5,1024);
+    index_tester<sjtu::prime_index,sjtu::incremental_storage>(6,7);
+    std::cout << c[7] << std::endl;
+}
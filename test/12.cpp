@@ -0,0 +1,121 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: string keys, chained",
+    "test2: string keys, incremental",
+    "test3: string keys, swiss",
+    "test4: string keys, hash not cached",
+    "test5: string keys, linked_hashmap",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+// every key hashes to one of 8 values, so the stored hash
+// has to be compared together with the key itself
+class CollidingHash {
+   public:
+    size_t operator()(const std::string &s) const {
+        return std::hash<std::string>()(s) & 7;
+    }
+};
+class PlainHash {
+   public:
+    size_t operator()(const std::string &s) const {
+        return std::hash<std::string>()(s);
+    }
+};
+namespace sjtu {
+template <>
+struct cache_hash<PlainHash> : std::false_type {};
+}
+
+std::string key(int i){
+    return "/api/v1/users/profile/" + std::to_string(i);
+}
+
+template<class mp>
+void string_tester(int title, int n){
+    using value_type = sjtu::pair<std::string,int>;
+    if(STATUS)std::cout<<c[title];
+    mp map;
+    for(int i=0;i<n;i++){
+        map.insert(value_type(key(i),i));
+    }
+    for(int i=0;i<n;i+=4){
+        map.insert(value_type(key(i),4*i));
+    }
+    for(int i=0;i<n;i+=3){
+        map.remove(key(i));
+    }
+    mp map2(map);
+    int found = 0;
+    for(int i=0;i<n;i++){
+        typename mp::iterator it = map2.find(key(i));
+        if(i%3==0){
+            if(it != map2.end()){
+                std::cout<<c[1]<<std::endl;
+                exit(0);
+            }
+        }
+        else{
+            if(it == map2.end() || (*it).second != (i%4 ? i : 4*i)){
+                std::cout<<c[1]<<std::endl;
+                exit(0);
+            }
+            found++;
+        }
+    }
+    std::cout<<found<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void string_linked_hashmap_tester(){
+    using value_type = sjtu::pair<std::string,int>;
+    using mp = sjtu::linked_hashmap<std::string,int>;
+    if(STATUS)std::cout<<c[6];
+    mp map;
+    for(int i=0;i<20;i++){
+        map.insert(value_type(key(i),i));
+    }
+    for(int i=0;i<20;i+=4){
+        map.insert(value_type(key(i),4*i));
+    }
+    for(mp::iterator it = map.begin();it!=map.end();){
+        mp::iterator tmpit = it;
+        it++;
+        if((*tmpit).second % 3 == 0) map.remove(tmpit);
+    }
+    for(mp::iterator it = map.begin();it!=map.end();it++){
+        std::cout<<(*it).first<<" "<<(*it).second<<" "<<map.at((*it).first)<<std::endl;
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("12.out","w",stdout);
+#endif
+    using std_hash = std::hash<std::string>;
+    using std_equal = std::equal_to<std::string>;
+    static_assert(sjtu::cache_hash<std_hash>::value, "string hash is cached");
+    static_assert(!sjtu::cache_hash<std::hash<int> >::value, "int hash is not");
+    static_assert(!sjtu::cache_hash<Hash>::value, "Integer hash is not");
+    string_tester<sjtu::hashmap<std::string,int> >(2,20000);
+    string_tester<sjtu::hashmap<std::string,int,CollidingHash,std_equal> >(2,2000);
+    string_tester<sjtu::hashmap<std::string,int,std_hash,std_equal,sjtu::incremental_storage> >(3,20000);
+    string_tester<sjtu::hashmap<std::string,int,std_hash,std_equal,sjtu::swiss_storage> >(4,20000);
+    string_tester<sjtu::hashmap<std::string,int,CollidingHash,std_equal,sjtu::swiss_storage> >(4,2000);
+    string_tester<sjtu::hashmap<std::string,int,PlainHash,std_equal> >(5,20000);
+    string_linked_hashmap_tester();
+    std::cout << c[7] << std::endl;
+}
@@ -0,0 +1,169 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: pool allocator, chained",
+    "test2: pool allocator, incremental",
+    "test3: pool allocator, swiss",
+    "test4: pool allocator, linked_hashmap",
+    "test5: lru steady state",
+    "test6: caches with their own allocator",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+// keep n keys alive, then insert one and remove the oldest one
+// for many rounds: once warm, the pool must not carve any more nodes
+template<class mp>
+void churn_tester(int title, int n){
+    using value_type = sjtu::pair<int,int>;
+    if(STATUS)std::cout<<c[title];
+    mp map;
+    for(int i=0;i<n;i++){
+        map.insert(value_type(i,i));
+    }
+    map.insert(value_type(n,n));
+    map.remove(n);
+    size_t warm = map.get_allocator().pooled();
+    for(int i=n;i<20*n;i++){
+        map.insert(value_type(i,i));
+        map.remove(i-n);
+    }
+    if(map.get_allocator().pooled() != warm) fail();
+    mp map2(map);
+    long long sum = 0;
+    for(int i=0;i<20*n;i++){
+        typename mp::iterator it = map2.find(i);
+        if((i<19*n) != (it == map2.end())) fail();
+        if(it != map2.end()) sum += (*it).second;
+    }
+    std::cout<<warm<<" "<<sum<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void linked_churn_tester(){
+    using value_type = sjtu::pair<int,int>;
+    using mp = sjtu::linked_hashmap<int,int,std::hash<int>,std::equal_to<int>,
+        sjtu::chained_storage,sjtu::prime_index,
+        sjtu::pool_allocator<sjtu::pair<const int,int> > >;
+    if(STATUS)std::cout<<c[5];
+    const int n=1000;
+    mp map;
+    for(int i=0;i<=n;i++){
+        map.insert(value_type(i,i));
+    }
+    map.remove(map.begin());
+    size_t warm = map.get_allocator().pooled();
+    for(int i=n+1;i<20*n;i++){
+        map.insert(value_type(i,i));
+        map.remove(map.begin());
+    }
+    if(map.get_allocator().pooled() != warm) fail();
+    map.clear();
+    for(int i=0;i<n;i++){
+        map.insert(value_type(i,2*i));
+    }
+    if(map.get_allocator().pooled() != warm) fail();
+    int cnt = 0;
+    for(mp::iterator it = map.begin();it!=map.end();it++){
+        if((*it).first != cnt || (*it).second != 2*cnt) fail();
+        cnt++;
+    }
+    std::cout<<warm<<" "<<cnt<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void lru_tester(){
+    using value_type = sjtu::pair<Integer,Matrix<int> >;
+    if(STATUS)std::cout<<c[6];
+    sjtu::lru tester(100);
+    for(int i=0;i<200;i++){
+        tester.save(value_type(Integer(i),Matrix<int>(2,2,i)));
+    }
+    size_t warm = tester.mp.get_allocator().pooled();
+    for(int i=200;i<10000;i++){
+        tester.save(value_type(Integer(i),Matrix<int>(2,2,i)));
+        if(!tester.get(Integer(i-(i%99)))) fail();
+    }
+    if(tester.mp.get_allocator().pooled() != warm) fail();
+    std::cout<<warm<<" "<<tester.mp.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// counts the nodes it hands out, whatever they are rebound to
+long long live = 0, handed = 0;
+template<class T>
+class counting_allocator {
+public:
+    using value_type = T;
+    counting_allocator() {}
+    template<class U>
+    counting_allocator(const counting_allocator<U> &) {}
+    T *allocate(size_t n){
+        live += n, handed += n;
+        return static_cast<T *>(::operator new(n*sizeof(T)));
+    }
+    void deallocate(T *p, size_t n){
+        live -= n;
+        ::operator delete(p);
+    }
+    template<class U>
+    bool operator==(const counting_allocator<U> &) const { return true; }
+    template<class U>
+    bool operator!=(const counting_allocator<U> &) const { return false; }
+};
+
+template<class Policy>
+void alloc_tester(){
+    using alloc = counting_allocator<sjtu::pair<const int,int> >;
+    handed = 0;
+    {
+        sjtu::basic_lru<int,int,std::hash<int>,std::equal_to<int>,size_t,Policy,alloc> tester(50);
+        for(int i=0;i<1000;i++){
+            tester.save(i%150,i);
+            tester.get(i%7);
+        }
+        if(tester.size() != 50) fail();
+        if(live <= 0) fail();
+    }
+    if(live != 0 || handed == 0) fail();
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("13.out","w",stdout);
+#endif
+    using pool = sjtu::pool_allocator<sjtu::pair<const int,int> >;
+    using std_hash = std::hash<int>;
+    using std_equal = std::equal_to<int>;
+    churn_tester<sjtu::hashmap<int,int,std_hash,std_equal,sjtu::chained_storage,sjtu::prime_index,pool> >(2,1000);
+    churn_tester<sjtu::hashmap<int,int,std_hash,std_equal,sjtu::incremental_storage,sjtu::prime_index,pool> >(3,1000);
+    churn_tester<sjtu::hashmap<int,int,std_hash,std_equal,sjtu::swiss_storage,sjtu::prime_index,pool> >(4,1000);
+    linked_churn_tester();
+    lru_tester();
+    if(STATUS)std::cout<<c[7];
+    alloc_tester<sjtu::lru_policy>();
+    alloc_tester<sjtu::clock_policy>();
+    alloc_tester<sjtu::slru_policy>();
+    alloc_tester<sjtu::two_queue_policy>();
+    alloc_tester<sjtu::arc_policy>();
+    alloc_tester<sjtu::w_tinylfu_policy>();
+    alloc_tester<sjtu::lfu_policy>();
+    std::cout<<"alloc ok"<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+    std::cout << c[8] << std::endl;
+}
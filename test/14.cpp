@@ -0,0 +1,133 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: double_list move_to_tail & move_to_head",
+    "test2: double_list splice",
+    "test3: linked_hashmap touch & update",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+using list = sjtu::double_list<int>;
+
+void print(list &l){
+    for(list::iterator it = l.begin();it!=l.end();it++){
+        std::cout<<*it<<" ";
+    }
+    std::cout<<"| ";
+    // walk back from the tail to check the prev links
+    list::iterator it = l.get_tail();
+    while(it!=l.end()){
+        std::cout<<*it<<" ";
+        it.cur = it.cur->prev;
+    }
+    std::cout<<std::endl;
+}
+
+list::iterator nth(list &l, int n){
+    list::iterator it = l.begin();
+    while(n--) it++;
+    return it;
+}
+
+void move_tester(){
+    if(STATUS)std::cout<<c[2];
+    list l;
+    for(int i=0;i<6;i++) l.insert_tail(i);
+    l.move_to_tail(nth(l,2));
+    print(l);
+    l.move_to_tail(l.get_tail());
+    l.move_to_tail(l.end());
+    l.move_to_head(nth(l,5));
+    print(l);
+    l.move_to_head(l.begin());
+    l.move_to_tail(l.begin());
+    print(l);
+    list one;
+    one.insert_tail(7);
+    one.move_to_head(one.begin());
+    one.move_to_tail(one.begin());
+    print(one);
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void splice_tester(){
+    if(STATUS)std::cout<<c[3];
+    list a, b;
+    for(int i=0;i<4;i++) a.insert_tail(i);
+    for(int i=10;i<14;i++) b.insert_tail(i);
+    a.splice(nth(a,1), b, nth(b,2));
+    print(a);
+    print(b);
+    a.splice(a.end(), b, b.begin());
+    a.splice(a.begin(), b, b.get_tail());
+    print(a);
+    print(b);
+    // inside one list
+    a.splice(a.begin(), a, a.get_tail());
+    a.splice(a.end(), a, nth(a,2));
+    print(a);
+    for(int i=20;i<23;i++) b.insert_tail(i);
+    a.splice(nth(a,3), b);
+    print(a);
+    print(b);
+    for(int i=30;i<32;i++) b.insert_tail(i);
+    a.splice(a.begin(), b);
+    for(int i=40;i<42;i++) b.insert_tail(i);
+    a.splice(a.end(), b);
+    print(a);
+    b.splice(b.end(), a);
+    print(a);
+    print(b);
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void touch_tester(){
+    using value_type = sjtu::pair<int,int>;
+    using mp = sjtu::linked_hashmap<int,int>;
+    if(STATUS)std::cout<<c[4];
+    mp map;
+    for(int i=0;i<10;i++) map.insert(value_type(i,i));
+    int *addr = &map.at(3);
+    mp::iterator it = map.touch(3);
+    if(&(*it).second != addr || (*it).first != 3) {
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    if(map.touch(100) != map.end()){
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    map.touch(0);
+    map.touch(0);
+    map.insert(value_type(5,50));
+    if(&map.at(3) != addr){
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    for(mp::iterator it = map.begin();it!=map.end();it++){
+        std::cout<<(*it).first<<" "<<(*it).second<<" ";
+    }
+    std::cout<<map.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("14.out","w",stdout);
+#endif
+    move_tester();
+    splice_tester();
+    touch_tester();
+    std::cout << c[5] << std::endl;
+}
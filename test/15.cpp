@@ -0,0 +1,107 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <memory>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: basic_lru<std::string,int>",
+    "test2: move-only value",
+    "test3: copies of the value",
+    "test4: size 0",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+void string_lru_tester(){
+    if(STATUS)std::cout<<c[2];
+    using cache = sjtu::basic_lru<std::string,int>;
+    cache tester(3);
+    for(int i=0;i<5;i++){
+        tester.save(cache::value_type(std::to_string(i),i));
+    }
+    tester.get("2");
+    tester.save("3",30);
+    tester.save(std::string("5"),5);
+    if(tester.get("1") != nullptr || *tester.get("3") != 30) fail();
+    tester.print();
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void move_only_tester(){
+    if(STATUS)std::cout<<c[3];
+    using cache = sjtu::basic_lru<int,std::unique_ptr<int>,std::hash<int>,std::equal_to<int>,short>;
+    cache tester(2);
+    tester.save(1,std::unique_ptr<int>(new int(10)));
+    std::unique_ptr<int> *p = tester.emplace(2,new int(20));
+    if(!p || **p != 20) fail();
+    // an existing key is only promoted
+    if(tester.emplace(1,nullptr) == nullptr) fail();
+    tester.save(cache::value_type(3,std::unique_ptr<int>(new int(30))));
+    if(tester.get(2) != nullptr) fail();
+    tester.save(1,std::unique_ptr<int>(new int(11)));
+    for(auto it=tester.mp.begin();it!=tester.mp.end();it++){
+        std::cout<<(*it).first<<" "<<*(*it).second<<std::endl;
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+class Counted {
+   public:
+    static int copies;
+    int val;
+    Counted(int val) : val(val) {}
+    Counted(const Counted &other) : val(other.val) { copies++; }
+    Counted(Counted &&other) : val(other.val) {}
+    Counted &operator=(const Counted &other) { val = other.val; copies++; return *this; }
+    Counted &operator=(Counted &&other) { val = other.val; return *this; }
+};
+int Counted::copies = 0;
+
+void copy_tester(){
+    if(STATUS)std::cout<<c[4];
+    using cache = sjtu::basic_lru<int,Counted>;
+    cache tester(100);
+    for(int i=0;i<200;i++){
+        tester.save(sjtu::pair<int,Counted>(i,Counted(i)));
+        tester.save(i,Counted(2*i));
+        tester.emplace(i+1,i);
+        tester.get(i/2);
+    }
+    Counted x(7);
+    tester.save(7,x);
+    std::cout<<Counted::copies<<" "<<tester.mp.size()<<" "<<tester.get(150)->val<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void zero_tester(){
+    if(STATUS)std::cout<<c[5];
+    sjtu::basic_lru<int,int> tester(0);
+    tester.save(1,1);
+    if(tester.emplace(2,2) != nullptr || tester.get(1) != nullptr) fail();
+    std::cout<<tester.mp.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("15.out","w",stdout);
+#endif
+    string_lru_tester();
+    move_only_tester();
+    copy_tester();
+    zero_tester();
+    std::cout << c[6] << std::endl;
+}
@@ -0,0 +1,125 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <random>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: lru_policy",
+    "test2: clock_policy",
+    "test3: slru_policy",
+    "test4: two_queue_policy",
+    "test5: arc_policy",
+    "test6: lfu_policy",
+    "test7: w_tinylfu_policy",
+    "test8: w_tinylfu admission",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+template<class Policy>
+using cache = sjtu::basic_lru<int,int,std::hash<int>,std::equal_to<int>,size_t,Policy>;
+
+template<class Policy>
+void dump(cache<Policy> &tester){
+    tester.for_each([](const int &key, int &value){
+        std::cout<<key<<":"<<value<<" ";
+    });
+    std::cout<<std::endl;
+}
+
+// a small hand-checked trace, then a long random one that checks
+// the capacity, the values and the hits against a plain array
+template<class Policy>
+void policy_tester(int title){
+    if(STATUS)std::cout<<c[title];
+    cache<Policy> tester(4);
+    for(int i=0;i<4;i++) tester.save(i,i);
+    tester.get(0);
+    tester.get(1);
+    tester.get(0);
+    tester.save(4,4);
+    tester.save(5,5);
+    tester.get(5);
+    tester.save(0,100);
+    tester.save(2,2);
+    tester.save(6,6);
+    dump(tester);
+
+    const int n=64, cap=16;
+    cache<Policy> big(cap);
+    int value[n];
+    for(int i=0;i<n;i++) value[i]=-1;
+    std::mt19937 rng(title);
+    int hits=0;
+    for(int step=0;step<100000;step++){
+        int key = rng()%4 ? rng()%24 : rng()%n;
+        if(rng()%2){
+            int *p = big.get(key);
+            if(p){
+                if(*p != value[key]) fail();
+                hits++;
+            }
+        }else{
+            value[key] = step;
+            if(step%3) big.save(key,step);
+            else if(*big.emplace(key,step) != step) big.save(key,step);
+        }
+        if(big.size() > (size_t)cap) fail();
+    }
+    int count=0;
+    big.for_each([&](const int &key, int &v){
+        if(v != value[key]) fail();
+        count++;
+    });
+    if(count != (int)big.size()) fail();
+    std::cout<<hits<<" "<<count<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// a hot set used again and again survives a long scan of keys used once
+void admission_tester(){
+    if(STATUS)std::cout<<c[9];
+    cache<sjtu::w_tinylfu_policy> tester(200);
+    for(int round=0;round<10;round++){
+        for(int i=0;i<150;i++){
+            if(!tester.get(i)) tester.save(i,i);
+        }
+    }
+    for(int i=1000;i<100000;i++){
+        if(!tester.get(i)) tester.save(i,i);
+    }
+    int hot=0;
+    for(int i=0;i<150;i++){
+        if(tester.get(i)) hot++;
+    }
+    std::cout<<hot<<" "<<tester.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("16.out","w",stdout);
+#endif
+    policy_tester<sjtu::lru_policy>(2);
+    policy_tester<sjtu::clock_policy>(3);
+    policy_tester<sjtu::slru_policy>(4);
+    policy_tester<sjtu::two_queue_policy>(5);
+    policy_tester<sjtu::arc_policy>(6);
+    policy_tester<sjtu::lfu_policy>(7);
+    policy_tester<sjtu::w_tinylfu_policy>(8);
+    admission_tester();
+    std::cout << c[10] << std::endl;
+}
@@ -0,0 +1,149 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: byte budget of Matrix values",
+    "test2: replacing a value reweighs it",
+    "test3: custom weigher",
+    "test4: changing a value through get",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using matrix_cache = sjtu::basic_lru<int,Matrix<int>,std::hash<int>,std::equal_to<int>,size_t,
+    sjtu::weighted_lru_policy<> >;
+
+void dump(matrix_cache &tester){
+    tester.for_each([](const int &key, Matrix<int> &value){
+        std::cout<<key<<":"<<value.RowSize()<<"x"<<value.ColSize()<<" ";
+    });
+    std::cout<<tester.size()<<" "<<tester.weight()<<std::endl;
+}
+
+void budget_tester(){
+    if(STATUS)std::cout<<c[2];
+    // 64 ints
+    matrix_cache tester(64*sizeof(int));
+    tester.save(0,Matrix<int>(2,2,0));
+    tester.save(1,Matrix<int>(4,4,1));
+    tester.save(2,Matrix<int>(2,8,2));
+    tester.save(3,Matrix<int>(5,5,3));
+    dump(tester);
+    tester.get(0);
+    tester.save(4,Matrix<int>(4,5,4));
+    dump(tester);
+    tester.emplace(5,1,1,5);
+    dump(tester);
+    // heavier than the whole budget: it evicts everything, itself too
+    if(tester.emplace(6,9,9,6) != nullptr) fail();
+    dump(tester);
+    long long bytes=0;
+    for(int i=0;i<1000;i++){
+        tester.save(i,Matrix<int>(1+i%7,1+i%5,i));
+        if(tester.weight() > 64*sizeof(int)) fail();
+        bytes += tester.size();
+    }
+    size_t sum=0;
+    tester.for_each([&](const int &, Matrix<int> &value){
+        sum += value.RowSize()*value.ColSize()*sizeof(int);
+    });
+    if(sum != tester.weight()) fail();
+    std::cout<<bytes<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void replace_tester(){
+    if(STATUS)std::cout<<c[3];
+    matrix_cache tester(64*sizeof(int));
+    for(int i=0;i<4;i++){
+        tester.save(i,Matrix<int>(4,4,i));
+    }
+    dump(tester);
+    // 1 grows from 16 to 40 ints, the two oldest others make room
+    tester.save(1,Matrix<int>(5,8,1));
+    dump(tester);
+    tester.save(1,Matrix<int>(1,2,1));
+    dump(tester);
+    tester.save(sjtu::pair<int,Matrix<int> >(3,Matrix<int>(2,2,3)));
+    dump(tester);
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+class LengthWeigher {
+   public:
+    size_t operator()(const std::string &s) const { return s.size(); }
+};
+
+void custom_tester(){
+    if(STATUS)std::cout<<c[4];
+    sjtu::basic_lru<int,std::string,std::hash<int>,std::equal_to<int>,int,
+        sjtu::weighted_lru_policy<LengthWeigher> > tester(10);
+    tester.save(0,std::string("abcd"));
+    tester.save(1,std::string("efg"));
+    tester.save(2,std::string("hi"));
+    tester.save(3,std::string("jk"));
+    tester.print();
+    std::cout<<tester.weight()<<std::endl;
+    // unit weights count entries, like lru_policy
+    sjtu::basic_lru<int,std::string,std::hash<int>,std::equal_to<int>,int,
+        sjtu::weighted_lru_policy<sjtu::unit_weigher> > units(2);
+    units.save(0,std::string("a"));
+    units.save(1,std::string("bcdefgh"));
+    units.save(2,std::string("ijklmnopq"));
+    units.print();
+    std::cout<<units.weight()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void grow_tester(){
+    if(STATUS)std::cout<<c[5];
+    sjtu::basic_lru<int,std::string,std::hash<int>,std::equal_to<int>,int,
+        sjtu::weighted_lru_policy<LengthWeigher> > tester(10);
+    tester.save(0,std::string("ab"));
+    tester.save(1,std::string("cd"));
+    // the weight was taken on save, growing the value keeps it
+    *tester.get(0) += "efghijklmn";
+    std::cout<<tester.weight()<<std::endl;
+    // 0 still counts the 2 it was saved with, and gives back 2 when evicted
+    if(tester.emplace(2,std::string("opqrst")) == nullptr) fail();
+    if(tester.emplace(3,std::string("uv")) == nullptr) fail();
+    tester.print();
+    std::cout<<tester.weight()<<std::endl;
+    // replacing a grown value takes off its saved weight, not its length
+    tester.save(1,std::string("w"));
+    *tester.get(1) += "xyzxyzxyz";
+    tester.save(1,std::string("xy"));
+    if(tester.get(1) == nullptr) fail();
+    for(int i=4;i<20;i++){
+        if(tester.emplace(i,std::string(1+i%3,'z')) == nullptr) fail();
+        if(tester.weight() > 10) fail();
+    }
+    tester.print();
+    std::cout<<tester.weight()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("17.out","w",stdout);
+#endif
+    budget_tester();
+    replace_tester();
+    custom_tester();
+    grow_tester();
+    std::cout << c[6] << std::endl;
+}
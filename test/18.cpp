@@ -0,0 +1,152 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <random>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: default ttl",
+    "test2: per-entry ttl & tti",
+    "test3: cleanup(budget)",
+    "test4: random times against a reference",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+// a clock the test moves by hand, in milliseconds
+class manual_clock {
+   public:
+    using duration = std::chrono::milliseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<manual_clock>;
+    static const bool is_steady = true;
+    static long long current;
+    static time_point now() { return time_point(duration(current)); }
+};
+long long manual_clock::current = 0;
+
+using ms = std::chrono::milliseconds;
+using cache = sjtu::expiring_lru<int,int,std::hash<int>,std::equal_to<int>,size_t,manual_clock>;
+
+void ttl_tester(){
+    if(STATUS)std::cout<<c[2];
+    manual_clock::current = 0;
+    cache tester(10, ms(100));
+    for(int i=0;i<5;i++){
+        tester.save(i,i);
+        manual_clock::current += 30;
+    }
+    // saved at 0 30 60 90 120, now 150
+    for(int i=0;i<5;i++){
+        std::cout<<(tester.get(i) ? 1 : 0)<<" ";
+    }
+    std::cout<<tester.size()<<std::endl;
+    tester.save(3,33);
+    manual_clock::current = 215;
+    std::cout<<(tester.get(3) ? *tester.get(3) : -1)<<" "<<(tester.get(4) ? 1 : 0)<<std::endl;
+    manual_clock::current = 1000;
+    std::cout<<tester.cleanup()<<" "<<tester.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void tti_tester(){
+    if(STATUS)std::cout<<c[3];
+    manual_clock::current = 0;
+    cache tester(10);
+    tester.save(0,0);
+    tester.save(1,1,ms(50));
+    tester.save(2,2,ms(0),ms(20));
+    tester.save(3,3,ms(100),ms(30));
+    for(int t=10;t<=120;t+=10){
+        manual_clock::current = t;
+        // 2 and 3 are read every 10ms until 60
+        if(t<=60){
+            tester.get(2);
+            tester.get(3);
+        }
+        tester.cleanup();
+        std::cout<<tester.size()<<" ";
+    }
+    std::cout<<std::endl;
+    tester.print();
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void cleanup_tester(){
+    if(STATUS)std::cout<<c[4];
+    manual_clock::current = 0;
+    cache tester(1000, ms(10));
+    for(int i=0;i<500;i++) tester.save(i,i);
+    manual_clock::current = 20;
+    std::cout<<tester.cleanup(100)<<" "<<tester.size()<<" ";
+    std::cout<<tester.cleanup(1000)<<" "<<tester.size()<<" ";
+    // every save reclaims a few on its own
+    for(int i=0;i<500;i++) tester.save(i,i);
+    manual_clock::current = 40;
+    for(int i=500;i<600;i++) tester.save(i,i);
+    std::cout<<tester.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// deadlines from a few ms to hours, so every level of the wheel is used
+void random_tester(){
+    if(STATUS)std::cout<<c[5];
+    manual_clock::current = 0;
+    const int n=2000;
+    cache tester(n);
+    long long deadline[n];
+    for(int i=0;i<n;i++) deadline[i]=-1;
+    std::mt19937 rng(13);
+    long long spans[]={50, 5000, 300000, 20000000, 4000000000LL};
+    int hits=0;
+    for(int step=0;step<200000;step++){
+        manual_clock::current += rng()%3 ? rng()%4 : rng()%2000;
+        if(step%50000==49999) manual_clock::current += 3000000;
+        long long now = manual_clock::current;
+        int key = rng()%n;
+        if(rng()%2){
+            int *p = tester.get(key);
+            bool alive = deadline[key] > now;
+            if((p != nullptr) != alive) fail();
+            if(p) hits++;
+            if(!alive) deadline[key] = -1;
+        }else{
+            long long span = spans[rng()%5];
+            long long ttl = 1 + rng()%span;
+            tester.save(key,step,ms(ttl));
+            deadline[key] = now + ttl;
+        }
+        if(step%1000==0){
+            tester.cleanup();
+            int alive=0;
+            for(int i=0;i<n;i++) if(deadline[i] > now) alive++;
+            if((int)tester.size() != alive) fail();
+        }
+    }
+    std::cout<<hits<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("18.out","w",stdout);
+#endif
+    ttl_tester();
+    tti_tester();
+    cleanup_tester();
+    random_tester();
+    std::cout << c[6] << std::endl;
+}
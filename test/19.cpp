@@ -0,0 +1,133 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: shards & capacity split",
+    "test2: threads on disjoint keys",
+    "test3: threads on shared keys",
+    "test4: reads replayed in order",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using cache = sjtu::concurrent_lru<int,int>;
+
+void split_tester(){
+    if(STATUS)std::cout<<c[2];
+    cache tester(1000, 12);
+    for(int i=0;i<100000;i++) tester.save(i,i);
+    std::cout<<tester.shard_count()<<" "<<tester.size()<<" ";
+    sjtu::concurrent_lru<int,int,std::hash<int>,std::equal_to<int>,size_t,
+        sjtu::lru_policy,sjtu::padded_split> padded(1000, 16);
+    for(int i=0;i<100000;i++) padded.save(i,i);
+    std::cout<<padded.size()<<" ";
+    cache single(10, 1);
+    for(int i=0;i<100;i++) single.save(i,i);
+    int v=-1;
+    if(!single.get(99,v) || v != 99 || single.get(89,v)) fail();
+    std::cout<<single.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// every thread owns its keys: whatever it still finds is its last value.
+// the hash never splits keys perfectly even, so the shards get room to spare
+void disjoint_tester(){
+    if(STATUS)std::cout<<c[3];
+    const int threads=4, n=20000;
+    cache tester(2*threads*n);
+    std::vector<std::thread> pool;
+    std::atomic<int> errors(0);
+    for(int t=0;t<threads;t++){
+        pool.emplace_back([&,t](){
+            for(int i=0;i<n;i++) tester.save(t*n+i,i);
+            for(int i=0;i<n;i+=2) tester.save(t*n+i,2*i);
+            for(int i=0;i<n;i++){
+                int v;
+                if(!tester.get(t*n+i,v) || v != (i%2 ? i : 2*i)) errors++;
+            }
+        });
+    }
+    for(auto &th : pool) th.join();
+    if(errors) fail();
+    std::cout<<tester.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// threads fight over a small key range: the cache never holds more
+// than its capacity and every value found is one a thread saved
+void shared_tester(){
+    if(STATUS)std::cout<<c[4];
+    const int threads=4;
+    cache tester(256, 8);
+    std::vector<std::thread> pool;
+    std::atomic<int> errors(0);
+    for(int t=0;t<threads;t++){
+        pool.emplace_back([&,t](){
+            unsigned x = t+1;
+            for(int i=0;i<50000;i++){
+                x = x*1103515245u+12345u;
+                int key = (x>>8)%1024;
+                if(x%3){
+                    tester.visit(key,[&](const int &v){
+                        if(v % 1024 != key) errors++;
+                    });
+                }else{
+                    tester.save(key,key+1024*t);
+                }
+                if(i%1000==0 && tester.size() > 256) errors++;
+            }
+        });
+    }
+    for(auto &th : pool) th.join();
+    if(errors) fail();
+    std::cout<<(tester.size() <= 256)<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// a get only records its use, the next save (or a full read buffer)
+// promotes the entry before evicting anything
+void replay_tester(){
+    if(STATUS)std::cout<<c[5];
+    cache tester(3, 1);
+    for(int i=1;i<=3;i++) tester.save(i,i);
+    int v;
+    if(!tester.get(1,v) || v != 1) fail();
+    tester.save(4,4);
+    std::cout<<tester.get(1,v)<<tester.get(2,v)<<tester.get(3,v)<<" ";
+    // far more reads than the buffer holds: the newest ones survive
+    for(int r=0;r<100;r++){
+        if(!tester.get(4,v)) fail();
+    }
+    tester.get(3,v);
+    tester.save(5,5);
+    std::cout<<tester.get(1,v)<<tester.get(3,v)<<tester.get(4,v)<<tester.get(5,v)<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("19.out","w",stdout);
+#endif
+    split_tester();
+    disjoint_tester();
+    shared_tester();
+    replay_tester();
+    std::cout << c[6] << std::endl;
+}
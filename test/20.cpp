@@ -0,0 +1,167 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: concurrent_hashmap, one thread",
+    "test2: readers while writers insert, remove and grow",
+    "test3: retired nodes are freed",
+    "test4: writers growing the map together",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using mp = sjtu::concurrent_hashmap<int,std::string>;
+
+void single_tester(){
+    if(STATUS)std::cout<<c[2];
+    mp map;
+    for(int i=0;i<10000;i++){
+        if(!map.insert(sjtu::pair<int,std::string>(i,std::to_string(i)))) fail();
+    }
+    for(int i=0;i<10000;i+=2){
+        if(map.insert_or_assign(i,std::to_string(-i))) fail();
+    }
+    for(int i=0;i<10000;i+=3){
+        if(!map.remove(i)) fail();
+    }
+    if(map.remove(3) || map.try_emplace(1,"x")) fail();
+    if(!map.try_emplace(3,2,'7')) fail();
+    long long sum = 0;
+    for(int i=0;i<10000;i++){
+        std::string v;
+        if(map.find(i,v)) sum += std::stoi(v);
+        if(map.count(i) != (i%3 != 0 || i == 3)) fail();
+    }
+    std::string v;
+    map.find(3,v);
+    std::cout<<map.size()<<" "<<sum<<" "<<v<<" "<<(map.bucket_count() >= map.size())<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// keys below half stay put, the readers must always find them with
+// their value; the writers churn the upper half and force resizes
+void mixed_tester(){
+    if(STATUS)std::cout<<c[3];
+    const int n = 4096;
+    sjtu::concurrent_hashmap<int,long long> map(4);
+    for(int i=0;i<n/2;i++) map.insert(sjtu::pair<int,long long>(i,3LL*i));
+    std::atomic<bool> stop(false);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> pool;
+    for(int t=0;t<2;t++){
+        pool.emplace_back([&,t](){
+            for(int r=0;r<20;r++){
+                for(int i=n/2+t;i<n;i+=2) map.insert_or_assign(i,(long long)r);
+                for(int i=n/2+t;i<n;i+=2) if(!map.remove(i)) errors++;
+            }
+        });
+    }
+    for(int t=0;t<2;t++){
+        pool.emplace_back([&,t](){
+            unsigned x = t+7;
+            while(!stop.load()){
+                x = x*1103515245u+12345u;
+                int key = (x>>8)%n;
+                long long v;
+                bool found = map.find(key,v);
+                if(key < n/2 && (!found || v != 3LL*key)) errors++;
+                if(key >= n/2 && found && (v < 0 || v >= 20)) errors++;
+            }
+        });
+    }
+    pool[0].join();
+    pool[1].join();
+    stop.store(true);
+    pool[2].join();
+    pool[3].join();
+    if(errors) fail();
+    std::cout<<map.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void reclaim_tester(){
+    if(STATUS)std::cout<<c[4];
+    sjtu::epoch_domain &domain = sjtu::epoch_domain::instance();
+    {
+        mp map;
+        for(int i=0;i<1000;i++) map.insert_or_assign(i % 10, std::to_string(i));
+        for(int i=0;i<10;i++) map.remove(i);
+    }
+    // nobody is reading: two moves of the epoch free everything
+    domain.collect();
+    domain.collect();
+    std::cout<<domain.pending()<<" ";
+    {
+        mp map;
+        map.insert_or_assign(1,std::string("a"));
+        sjtu::epoch_guard guard;
+        map.insert_or_assign(1,std::string("b"));
+        domain.collect();
+        domain.collect();
+        domain.collect();
+        // the old node may still be read by this thread
+        std::cout<<(domain.pending() > 0)<<" ";
+    }
+    domain.collect();
+    domain.collect();
+    std::cout<<domain.pending()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// every insert may land in a table being moved: the threads share the
+// moving, nothing may get lost or duplicated on the way
+void grow_tester(){
+    if(STATUS)std::cout<<c[5];
+    const int threads = 4, n = 30000;
+    sjtu::concurrent_hashmap<int,int> map;
+    std::vector<std::thread> pool;
+    std::atomic<int> errors(0);
+    for(int t=0;t<threads;t++){
+        pool.emplace_back([&,t](){
+            for(int i=t;i<threads*n;i+=threads){
+                if(!map.insert(sjtu::pair<int,int>(i,i))) errors++;
+                int v;
+                if(!map.find(i,v) || v != i) errors++;
+                if(i % 7 == 0 && !map.remove(i)) errors++;
+            }
+        });
+    }
+    for(auto &th : pool) th.join();
+    if(errors) fail();
+    long long sum = 0;
+    for(int i=0;i<threads*n;i++){
+        int v;
+        if(map.find(i,v) != (i % 7 != 0)) fail();
+        if(i % 7) sum += v;
+    }
+    std::cout<<map.size()<<" "<<sum<<" "<<map.bucket_count()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("20.out","w",stdout);
+#endif
+    single_tester();
+    mixed_tester();
+    reclaim_tester();
+    grow_tester();
+    std::cout << c[6] << std::endl;
+}
@@ -0,0 +1,129 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: get_or_load, one thread",
+    "test2: a herd of misses loads once",
+    "test3: a failed load reaches every waiter",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+// the k-th power of the 2x2 matrix [[1,1],[1,0]], the slow way
+Matrix<int> fib_power(int k){
+    Matrix<int> r(2,2,0), a(2,2,0);
+    r[0][0] = r[1][1] = 1;
+    a[0][0] = a[0][1] = a[1][0] = 1;
+    for(int t=0;t<k;t++){
+        Matrix<int> p(2,2,0);
+        for(int i=0;i<2;i++)
+            for(int j=0;j<2;j++)
+                for(int l=0;l<2;l++) p[i][j] += r[i][l]*a[l][j];
+        r = p;
+    }
+    return r;
+}
+
+void single_tester(){
+    if(STATUS)std::cout<<c[2];
+    sjtu::basic_lru<int,Matrix<int> > tester(4);
+    int loads = 0;
+    auto loader = [&loads](int k){ loads++; return fib_power(k); };
+    for(int r=0;r<3;r++){
+        for(int k=10;k<14;k++){
+            Matrix<int> *m = tester.get_or_load(k,loader);
+            if(!m || !(*m == fib_power(k))) fail();
+        }
+    }
+    try{
+        tester.get_or_load(20,[](int)->Matrix<int>{ throw std::runtime_error("load"); });
+        fail();
+    }catch(std::runtime_error &){}
+    std::cout<<loads<<" "<<tester.size()<<" "<<(tester.get(20) == nullptr)
+             <<" "<<(*tester.get_or_load(10,loader))[0][1]<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// the loader is slow, so the other threads all miss while it runs
+void herd_tester(){
+    if(STATUS)std::cout<<c[3];
+    const int threads = 8;
+    sjtu::concurrent_lru<int,Matrix<int> > tester(64, 4);
+    std::atomic<int> loads(0), errors(0);
+    auto loader = [&loads](int k){
+        loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return fib_power(k);
+    };
+    std::vector<std::thread> pool;
+    for(int t=0;t<threads;t++){
+        pool.emplace_back([&,t](){
+            for(int k=30;k<34;k++){
+                Matrix<int> m = tester.get_or_load(k,loader);
+                if(!(m == fib_power(k))) errors++;
+            }
+        });
+    }
+    for(auto &th : pool) th.join();
+    if(errors) fail();
+    Matrix<int> m;
+    std::cout<<loads<<" "<<tester.size()<<" "<<tester.get(33,m)<<" "<<m[0][1]<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void failure_tester(){
+    if(STATUS)std::cout<<c[4];
+    const int threads = 8;
+    sjtu::concurrent_lru<int,int> tester(64, 4);
+    std::atomic<int> loads(0), caught(0);
+    std::vector<std::thread> pool;
+    for(int t=0;t<threads;t++){
+        pool.emplace_back([&](){
+            try{
+                tester.get_or_load(7,[&loads](int)->int{
+                    loads++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    throw std::runtime_error("load");
+                });
+            }catch(std::runtime_error &){
+                caught++;
+            }
+        });
+    }
+    for(auto &th : pool) th.join();
+    // nothing was saved, and the key can be loaded again
+    int v = 0;
+    if(tester.get(7,v) || loads < 1 || loads > threads) fail();
+    v = tester.get_or_load(7,[](int k){ return k*k; });
+    std::cout<<caught<<" "<<v<<" "<<tester.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("21.out","w",stdout);
+#endif
+    single_tester();
+    herd_tester();
+    failure_tester();
+    std::cout << c[5] << std::endl;
+}
@@ -0,0 +1,123 @@
+#include "async.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+// build with -std=c++20
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: a hit does not suspend",
+    "test2: awaiters of a key share one load",
+    "test3: a failed load reaches every awaiter",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using cache = sjtu::async_lru<int,long long>;
+
+std::atomic<int> loads(0), done(0), errors(0), caught(0);
+
+long long slow_square(int k){
+    loads++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return 1LL*k*k;
+}
+
+sjtu::detached request(cache &tester, int key){
+    long long v = co_await tester.get_async(key, slow_square);
+    if(v != 1LL*key*key) errors++;
+    done++;
+}
+
+sjtu::detached failing_request(cache &tester, int key){
+    try{
+        co_await tester.get_async(key, [](int)->long long{
+            loads++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            throw std::runtime_error("load");
+        });
+        errors++;
+    }catch(std::runtime_error &){
+        caught++;
+    }
+    done++;
+}
+
+// a hit never leaves the thread of the awaiter
+sjtu::detached same_thread(cache &tester, std::thread::id self, bool &same){
+    long long v = co_await tester.get_async(3, slow_square);
+    same = std::this_thread::get_id() == self && v == 9;
+    done++;
+}
+
+void wait_for(int n){
+    while(done.load() < n) std::this_thread::yield();
+    done = 0;
+}
+
+void hit_tester(sjtu::thread_pool &pool){
+    if(STATUS)std::cout<<c[2];
+    cache tester(16, pool);
+    tester.save(sjtu::pair<int,long long>(3, 9));
+    std::thread::id self = std::this_thread::get_id();
+    bool same = false;
+    same_thread(tester, self, same);
+    wait_for(1);
+    std::cout<<same<<" "<<loads<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void herd_tester(sjtu::thread_pool &pool){
+    if(STATUS)std::cout<<c[3];
+    cache tester(16, pool);
+    const int n = 2000;
+    loads = 0;
+    for(int i=0;i<n;i++) request(tester, i%10);
+    wait_for(n);
+    if(errors) fail();
+    long long v = 0;
+    std::cout<<loads<<" "<<tester.size()<<" "<<tester.get(7,v)<<" "<<v<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void failure_tester(sjtu::thread_pool &pool){
+    if(STATUS)std::cout<<c[4];
+    cache tester(16, pool);
+    const int n = 100;
+    loads = 0;
+    for(int i=0;i<n;i++) failing_request(tester, 5);
+    wait_for(n);
+    long long v = 0;
+    if(errors || loads < 1 || tester.get(5,v)) fail();
+    // the key can be loaded again
+    request(tester, 5);
+    wait_for(1);
+    std::cout<<caught<<" "<<tester.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("22.out","w",stdout);
+#endif
+    sjtu::thread_pool pool(4);
+    hit_tester(pool);
+    herd_tester(pool);
+    failure_tester(pool);
+    std::cout << c[5] << std::endl;
+}
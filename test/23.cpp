@@ -0,0 +1,183 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: bounded overshoot",
+    "test2: destructors off the save path",
+    "test3: background expiry",
+    "test4: removing by iterator compares no key",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using ms = std::chrono::milliseconds;
+
+// wait for the background thread, at most a few seconds
+template<class F>
+bool eventually(F done){
+    for(int i=0;i<5000;i++){
+        if(done()) return true;
+        std::this_thread::sleep_for(ms(1));
+    }
+    return false;
+}
+
+void overshoot_tester(){
+    if(STATUS)std::cout<<c[2];
+    sjtu::maintained_lru<sjtu::basic_lru<int,int> > tester(8, ms(1), 100);
+    size_t most = 0;
+    for(int i=0;i<5000;i++){
+        tester.save(i,i);
+        most = std::max(most, tester.size());
+    }
+    if(most > 108) fail();
+    tester.sync();
+    int v, kept = 0;
+    for(int i=0;i<5000;i++){
+        if(tester.get(i,v)){
+            if(v != i || i < 4900) fail();
+            kept++;
+        }
+    }
+    std::cout<<kept<<" "<<tester.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+std::thread::id saver;
+std::atomic<int> on_saver(0), elsewhere(0);
+
+// counts the destruction of every value that was cached
+struct tracked {
+    int v = 0;
+    bool live = false;
+    tracked() {}
+    explicit tracked(int v) : v(v), live(true) {}
+    tracked(const tracked &o) : v(o.v), live(o.live) {}
+    tracked(tracked &&o) : v(o.v), live(o.live) { o.live = false; }
+    tracked &operator=(const tracked &o){ v = o.v; live = o.live; return *this; }
+    ~tracked(){
+        if(!live) return;
+        if(std::this_thread::get_id() == saver) on_saver++;
+        else elsewhere++;
+    }
+};
+
+void destructor_tester(){
+    if(STATUS)std::cout<<c[3];
+    saver = std::this_thread::get_id();
+    {
+        sjtu::maintained_lru<sjtu::basic_lru<int,tracked> > tester(1000, ms(1), 100);
+        for(int i=0;i<1000;i++) tester.save(i,tracked(i));
+        if(!eventually([&](){ return tester.size() == 100; })) fail();
+        std::cout<<on_saver<<" "<<elsewhere<<" ";
+        tester.join();
+        // after join a save evicts inline
+        tester.save(1000,tracked(1000));
+        std::cout<<tester.size()<<" "<<on_saver<<" ";
+    }
+    std::cout<<on_saver+elsewhere<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+class manual_clock {
+   public:
+    using duration = std::chrono::milliseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<manual_clock>;
+    static const bool is_steady = true;
+    static std::atomic<long long> current;
+    static time_point now() { return time_point(duration(current.load())); }
+};
+std::atomic<long long> manual_clock::current(0);
+
+void expiry_tester(){
+    if(STATUS)std::cout<<c[4];
+    using cache = sjtu::expiring_lru<int,int,std::hash<int>,std::equal_to<int>,size_t,manual_clock>;
+    sjtu::maintained_lru<cache> tester(4, ms(1), 50, ms(100));
+    for(int i=0;i<20;i++){
+        tester.save(i,i);
+        manual_clock::current += 10;
+    }
+    // saved at 0..190, now 195: the first ten expired, nobody asks
+    // for them, the thread reclaims them anyway
+    manual_clock::current = 195;
+    if(!eventually([&](){ return tester.size() == 10; })) fail();
+    int v;
+    std::cout<<tester.size()<<" "<<tester.get(9,v)<<" "<<tester.get(10,v)<<" "<<v<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// counts the keys compared
+long long compared = 0;
+class CountingEqual {
+public:
+    bool operator()(const int &a, const int &b) const {
+        compared++;
+        return a == b;
+    }
+};
+
+template<class Storage>
+void unlink_tester(){
+    using mp = sjtu::linked_hashmap<int,int,std::hash<int>,CountingEqual,Storage>;
+    using value_type = sjtu::pair<int,int>;
+    mp map;
+    const int n = 5000;
+    for(int i=0;i<n;i++){
+        map.insert(value_type(i,i));
+    }
+    // every third one by iterator, the oldest through extract
+    compared = 0;
+    for(typename mp::iterator it = map.begin();it!=map.end();){
+        typename mp::iterator cur = it++;
+        if((*cur).first % 3 == 0) map.remove(cur);
+    }
+    for(int i=0;i<100;i++){
+        typename mp::Node *node = map.extract(map.begin());
+        map.destroy_node(node);
+        map.deallocate_node(node);
+    }
+    if(compared != 0) fail();
+    long long sum = 0;
+    for(int i=0;i<n;i++){
+        bool there = map.count(i);
+        if(there != (i % 3 != 0 && map.find(i) != map.end())) fail();
+        if(there) sum += map.at(i);
+    }
+    map.insert(value_type(0,7));
+    if(map.at(0) != 7) fail();
+    std::cout<<map.size()<<" "<<sum<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("23.out","w",stdout);
+#endif
+    overshoot_tester();
+    destructor_tester();
+    expiry_tester();
+    if(STATUS)std::cout<<c[5];
+    unlink_tester<sjtu::chained_storage>();
+    unlink_tester<sjtu::incremental_storage>();
+    unlink_tester<sjtu::swiss_storage>();
+    if(STATUS)std::cout<<c[0]<<std::endl;
+    std::cout << c[6] << std::endl;
+}
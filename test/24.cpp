@@ -0,0 +1,152 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: int lookups into Integer keys",
+    "test2: no key is built by a transparent lookup",
+    "test3: a plain Hash still converts the key",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+// a key that counts how often it is built
+class Name {
+public:
+    static int built;
+    int id;
+    explicit Name(int id) : id(id) {built++;}
+    Name(const Name &rhs) : id(rhs.id) {built++;}
+};
+int Name::built = 0;
+class NameHash {
+public:
+    using is_transparent = void;
+    size_t operator()(const Name &n) const {return n.id * 2654435761u;}
+    size_t operator()(int id) const {return id * 2654435761u;}
+};
+class NameEqual {
+public:
+    using is_transparent = void;
+    bool operator()(const Name &a, const Name &b) const {return a.id == b.id;}
+    bool operator()(const Name &a, int b) const {return a.id == b;}
+    bool operator()(int a, const Name &b) const {return a == b.id;}
+};
+
+// Hash without is_transparent: lookups convert an int into Integer
+class PlainHash {
+public:
+    unsigned int operator()(const Integer &x) const {return x.val;}
+};
+
+template<class Map>
+void probe(Map &mp){
+    for(int i=0;i<100;i++){
+        auto it = mp.find(i);
+        if(i%3 == 0){
+            if(it != mp.end()) fail();
+        }else if(it == mp.end() || (*it).second != i*7) fail();
+    }
+}
+
+void integer_tester(){
+    if(STATUS)std::cout<<c[2];
+    using value_type = sjtu::pair<const Integer,int>;
+    sjtu::hashmap<Integer,int,Hash,Equal> chained;
+    sjtu::hashmap<Integer,int,Hash,Equal,sjtu::swiss_storage> swiss;
+    sjtu::linked_hashmap<Integer,int,Hash,Equal> linked;
+    for(int i=0;i<100;i++){
+        chained.insert(value_type(Integer(i),i*7));
+        swiss.insert(value_type(Integer(i),i*7));
+        linked.insert(value_type(Integer(i),i*7));
+    }
+    for(int i=0;i<100;i+=3){
+        if(!chained.remove(i) || !swiss.remove(i)) fail();
+        linked.remove(linked.find(i));
+    }
+    if(chained.remove(0) || swiss.remove(3)) fail();
+    int before = Integer::counter;
+    probe(chained);
+    probe(swiss);
+    probe(linked);
+    const auto &view = linked;
+    if(view.at(4) != 28 || view.count(4) != 1 || linked.count(3) != 0) fail();
+    linked.at(4) = 5;
+    auto last = linked.touch(4);
+    if(Integer::counter != before) fail();
+    std::cout<<chained.size()<<" "<<swiss.size()<<" "<<linked.size()<<" "
+             <<(*last).first<<" "<<(*last).second<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void built_tester(){
+    if(STATUS)std::cout<<c[3];
+    using value_type = sjtu::pair<const Name,int>;
+    sjtu::hashmap<Name,int,NameHash,NameEqual> chained;
+    sjtu::hashmap<Name,int,NameHash,NameEqual,sjtu::swiss_storage> swiss;
+    sjtu::linked_hashmap<Name,int,NameHash,NameEqual> linked;
+    sjtu::basic_lru<Name,int,NameHash,NameEqual> lru(32);
+    sjtu::basic_lru<Name,int,NameHash,NameEqual,size_t,sjtu::w_tinylfu_policy> tiny(32);
+    for(int i=0;i<64;i++){
+        chained.insert(value_type(Name(i),i));
+        swiss.insert(value_type(Name(i),i));
+        linked.insert(value_type(Name(i),i));
+        lru.save(value_type(Name(i),i));
+        tiny.save(value_type(Name(i),i));
+    }
+    int before = Name::built;
+    long long sum = 0;
+    for(int r=0;r<4;r++){
+        for(int i=0;i<80;i++){
+            auto a = chained.find(i);
+            if(a != chained.end()) sum += (*a).second;
+            auto b = swiss.find(i);
+            if(b != swiss.end()) sum += (*b).second;
+            sum += linked.count(i);
+            if(int *v = lru.get(i)) sum += *v;
+            if(int *v = tiny.get(i)) sum += *v;
+        }
+    }
+    for(int i=0;i<64;i+=2) if(!chained.remove(i) || !swiss.remove(i)) fail();
+    std::cout<<Name::built-before<<" "<<sum<<" "<<chained.size()<<" "
+             <<swiss.size()<<" "<<lru.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void plain_tester(){
+    if(STATUS)std::cout<<c[4];
+    using value_type = sjtu::pair<const Integer,int>;
+    sjtu::hashmap<Integer,int,PlainHash,Equal> mp;
+    sjtu::basic_lru<Integer,int,PlainHash,Equal> lru(8);
+    for(int i=0;i<16;i++){
+        mp.insert(value_type(Integer(i),i));
+        lru.save(value_type(Integer(i),i));
+    }
+    if(!mp.remove(5) || mp.find(5) != mp.end() || (*mp.find(6)).second != 6) fail();
+    if(lru.get(3) || !lru.get(12) || *lru.get(12) != 12) fail();
+    std::cout<<mp.size()<<" "<<lru.size()<<" "<<Integer::counter<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("24.out","w",stdout);
+#endif
+    integer_tester();
+    built_tester();
+    plain_tester();
+    std::cout << c[5] << std::endl;
+}
@@ -0,0 +1,163 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: reserve sizes the table once",
+    "test2: shrink_to_fit after a purge",
+    "test3: max_load_factor and rehash",
+    "test4: linked_hashmap keeps its order",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using chained = sjtu::hashmap<int,int>;
+using incremental = sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::incremental_storage>;
+using swiss = sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage>;
+using value_type = sjtu::pair<const int,int>;
+
+template<class Map>
+void check(Map &mp,int n,int step){
+    for(int i=0;i<n;i++){
+        auto it = mp.find(i);
+        if(i%step == 0){
+            if(it == mp.end() || (*it).second != i+1) fail();
+        }else if(it != mp.end()) fail();
+    }
+}
+
+template<class Map>
+void reserve_run(){
+    const int n = 50000;
+    Map mp;
+    mp.reserve(n);
+    size_t buckets = mp.bucket_count();
+    for(int i=0;i<n;i++){
+        mp.insert(value_type(i,i+1));
+        if(mp.bucket_count() != buckets) fail();
+    }
+    if(mp.load_factor() > mp.max_load_factor()) fail();
+    check(mp,n,1);
+    std::cout<<mp.size()<<" ";
+}
+void reserve_tester(){
+    if(STATUS)std::cout<<c[2];
+    reserve_run<chained>();
+    reserve_run<incremental>();
+    reserve_run<swiss>();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+template<class Map>
+void shrink_run(){
+    const int n = 50000;
+    Map mp;
+    for(int i=0;i<n;i++) mp.insert(value_type(i,i+1));
+    size_t big = mp.bucket_count();
+    for(int i=0;i<n;i++) if(i%100) mp.remove(i);
+    mp.shrink_to_fit();
+    if(mp.bucket_count() * 10 > big || mp.load_factor() > mp.max_load_factor()) fail();
+    check(mp,n,100);
+    // it grows again as usual
+    for(int i=0;i<n;i++) if(i%100 == 50) mp.insert(value_type(i,i+1));
+    check(mp,n,50);
+    std::cout<<mp.size()<<" ";
+}
+void shrink_tester(){
+    if(STATUS)std::cout<<c[3];
+    shrink_run<chained>();
+    shrink_run<incremental>();
+    shrink_run<swiss>();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+template<class Map>
+void load_run(float ml){
+    Map mp;
+    for(int i=0;i<1000;i++) mp.insert(value_type(i,i+1));
+    mp.max_load_factor(ml);
+    if(mp.load_factor() > mp.max_load_factor()) fail();
+    for(int i=1000;i<3000;i++){
+        mp.insert(value_type(i,i+1));
+        if(mp.load_factor() > mp.max_load_factor()) fail();
+    }
+    size_t before = mp.bucket_count();
+    mp.rehash(before * 4);
+    if(mp.bucket_count() < before * 4) fail();
+    // never fewer buckets than the elements need
+    mp.rehash(1);
+    if(mp.load_factor() > mp.max_load_factor()) fail();
+    check(mp,3000,1);
+    Map copy(mp);
+    if(copy.max_load_factor() != mp.max_load_factor()) fail();
+    // a factor that is not positive is rejected and changes nothing
+    float bad[] = {0.0f, -1.0f, std::nanf("")};
+    for(float b : bad){
+        bool thrown = false;
+        try{
+            copy.max_load_factor(b);
+        }catch(...){
+            thrown = true;
+        }
+        if(!thrown || copy.max_load_factor() != mp.max_load_factor()) fail();
+    }
+    std::cout<<mp.max_load_factor()<<" ";
+}
+void load_tester(){
+    if(STATUS)std::cout<<c[4];
+    load_run<chained>(0.25f);
+    load_run<chained>(2.0f);
+    load_run<incremental>(0.5f);
+    load_run<swiss>(0.5f);
+    load_run<swiss>(2.0f);
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void order_tester(){
+    if(STATUS)std::cout<<c[5];
+    sjtu::linked_hashmap<Integer,Matrix<int>,Hash,Equal> mp;
+    mp.reserve(1000);
+    size_t buckets = mp.bucket_count();
+    for(int i=0;i<1000;i++) mp.insert(sjtu::pair<const Integer,Matrix<int> >(Integer(i),Matrix<int>(1,1,i)));
+    if(mp.bucket_count() != buckets) fail();
+    for(int i=0;i<1000;i++) if(i%7) mp.remove(mp.find(i));
+    mp.shrink_to_fit();
+    if(mp.bucket_count() >= buckets) fail();
+    mp.insert(sjtu::pair<const Integer,Matrix<int> >(Integer(0),Matrix<int>(1,1,-1)));
+    int last = -2;
+    for(auto it=mp.begin();it!=mp.end();it++){
+        int k = (*it).first.val;
+        if(k != 0 && k <= last) fail();
+        last = k;
+    }
+    std::cout<<mp.size()<<" "<<last<<" "<<mp.at(0)[0][0]<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("25.out","w",stdout);
+#endif
+    reserve_tester();
+    shrink_tester();
+    load_tester();
+    order_tester();
+    std::cout << c[6] << std::endl;
+}
@@ -0,0 +1,152 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: find_many agrees with find",
+    "test2: find_many on linked_hashmap, int keys",
+    "test3: get_many promotes like get",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using value_type = sjtu::pair<const int,int>;
+
+// the keys 0..2n-1 shuffled, half of them missing
+std::vector<int> queries(int n){
+    std::vector<int> keys;
+    unsigned x = 12345;
+    for(int i=0;i<2*n;i++){
+        x = x*1103515245u+12345u;
+        keys.push_back((x>>8)%(2*n));
+    }
+    return keys;
+}
+
+template<class Map>
+void many_run(){
+    const int n = 5000;
+    Map mp;
+    for(int i=0;i<n;i++) mp.insert(value_type(i*2,i));
+    std::vector<int> keys = queries(n);
+    // a size that is not a multiple of the batch
+    size_t m = keys.size()-7;
+    std::vector<typename Map::iterator> out(m);
+    mp.find_many(keys.data(),m,out.data());
+    int hits = 0;
+    for(size_t i=0;i<m;i++){
+        if(out[i] != mp.find(keys[i])) fail();
+        if(out[i] != mp.end()){
+            if((*out[i]).second*2 != keys[i]) fail();
+            hits++;
+        }
+    }
+    mp.find_many(keys.data(),0,out.data());
+    std::cout<<hits<<" ";
+}
+void many_tester(){
+    if(STATUS)std::cout<<c[2];
+    many_run<sjtu::hashmap<int,int> >();
+    many_run<sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::incremental_storage> >();
+    many_run<sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage> >();
+    many_run<sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::chained_storage,sjtu::fibonacci_index> >();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+template<class Storage>
+void linked_run(){
+    sjtu::linked_hashmap<Integer,Matrix<int>,Hash,Equal,Storage> mp;
+    for(int i=0;i<300;i++){
+        mp.insert(sjtu::pair<const Integer,Matrix<int> >(Integer(i),Matrix<int>(1,1,i)));
+    }
+    int keys[100];
+    for(int i=0;i<100;i++) keys[i] = 299-i*5;
+    typename decltype(mp)::iterator out[100];
+    int before = Integer::counter;
+    mp.find_many(keys,100,out);
+    if(Integer::counter != before) fail();
+    long long sum = 0;
+    for(int i=0;i<100;i++){
+        if(keys[i] < 0){
+            if(out[i] != mp.end()) fail();
+        }else{
+            if(out[i] == mp.end() || (*out[i]).first.val != keys[i]) fail();
+            sum += (*out[i]).second[0][0];
+        }
+    }
+    // the order is untouched
+    std::cout<<sum<<" "<<(*mp.begin()).first<<" ";
+}
+void linked_tester(){
+    if(STATUS)std::cout<<c[3];
+    linked_run<sjtu::chained_storage>();
+    linked_run<sjtu::swiss_storage>();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+template<class Policy>
+void promote_run(){
+    const int cap = 64;
+    sjtu::basic_lru<int,int,std::hash<int>,std::equal_to<int>,size_t,Policy> one(cap), many(cap);
+    for(int i=0;i<cap;i++){
+        one.save(value_type(i,i));
+        many.save(value_type(i,i));
+    }
+    std::vector<int> keys = queries(cap);
+    std::vector<int*> out(keys.size());
+    many.get_many(keys.data(),keys.size(),out.data());
+    for(size_t i=0;i<keys.size();i++){
+        int *v = one.get(keys[i]);
+        if((v == nullptr) != (out[i] == nullptr) || (v && *v != *out[i])) fail();
+    }
+    // the same entries are evicted afterwards
+    for(int i=cap;i<cap+cap/2;i++){
+        one.save(value_type(i,i));
+        many.save(value_type(i,i));
+    }
+    int alive = 0;
+    for(int i=0;i<cap+cap/2;i++){
+        bool a = one.get(i) != nullptr, b = many.get(i) != nullptr;
+        if(a != b) fail();
+        alive += a;
+    }
+    std::cout<<alive<<" ";
+}
+void promote_tester(){
+    if(STATUS)std::cout<<c[4];
+    promote_run<sjtu::lru_policy>();
+    promote_run<sjtu::clock_policy>();
+    promote_run<sjtu::slru_policy>();
+    promote_run<sjtu::two_queue_policy>();
+    promote_run<sjtu::arc_policy>();
+    promote_run<sjtu::w_tinylfu_policy>();
+    promote_run<sjtu::lfu_policy>();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("26.out","w",stdout);
+#endif
+    many_tester();
+    linked_tester();
+    promote_tester();
+    std::cout << c[5] << std::endl;
+}
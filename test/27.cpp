@@ -0,0 +1,218 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <iterator>
+#include <string>
+#include <vector>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: insert_range into hashmap",
+    "test2: linked_hashmap built from a range keeps its order",
+    "test3: a single pass input range",
+    "test4: pooled nodes come from one block",
+    "test5: a throwing copy leaves the list whole",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+using entry = sjtu::pair<int,int>;
+
+std::vector<entry> snapshot(int n,int from){
+    std::vector<entry> v;
+    for(int i=0;i<n;i++) v.push_back(entry(from+i*3,i));
+    return v;
+}
+
+// reads the pairs once, without knowing how many
+class reader {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = entry;
+    using difference_type = long;
+    using pointer = const entry *;
+    using reference = const entry &;
+    reader() : src(nullptr), pos(0) {}
+    reader(const std::vector<entry> &v) : src(&v), pos(0) {}
+    const entry &operator*() const {return (*src)[pos];}
+    reader &operator++(){
+        if(++pos == src->size()) src = nullptr;
+        return *this;
+    }
+    bool operator==(const reader &rhs) const {return src == rhs.src;}
+    bool operator!=(const reader &rhs) const {return src != rhs.src;}
+private:
+    const std::vector<entry> *src;
+    size_t pos;
+};
+
+template<class Map>
+void range_run(){
+    const int n = 20000;
+    std::vector<entry> v = snapshot(n,0);
+    Map mp(v.begin(),v.end());
+    Map sized;
+    sized.reserve(n);
+    if(mp.size() != (size_t)n || mp.bucket_count() != sized.bucket_count()) fail();
+    // half the keys exist already, their values are replaced
+    std::vector<entry> more = snapshot(n,n*3/2);
+    for(auto &e : more) e.second = -e.second;
+    mp.insert_range(more.begin(),more.end());
+    mp.insert_range(more.end(),more.end());
+    long long sum = 0;
+    for(int k=0;k<n*9/2;k++){
+        auto it = mp.find(k);
+        if(it != mp.end()) sum += (*it).second;
+    }
+    std::cout<<mp.size()<<" "<<sum<<" ";
+}
+void range_tester(){
+    if(STATUS)std::cout<<c[2];
+    range_run<sjtu::hashmap<int,int> >();
+    range_run<sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::incremental_storage> >();
+    range_run<sjtu::hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage> >();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+template<class Map>
+void order_run(){
+    std::vector<entry> v = snapshot(1000,0);
+    // 30 is repeated, and 3 updated again at the end
+    v.push_back(entry(30,-1));
+    v.push_back(entry(3,-2));
+    Map mp(v.begin(),v.end());
+    if(mp.size() != 1000) fail();
+    auto it = mp.begin();
+    for(int i=0;i<1000;i++){
+        if(i == 10 || i == 1) continue;
+        if((*it).first != i*3 || (*it).second != i) fail();
+        ++it;
+    }
+    if((*it).first != 30 || (*it).second != -1) fail();
+    ++it;
+    if((*it).first != 3 || (*it).second != -2 || ++it != mp.end()) fail();
+    // a second range goes after what is there
+    std::vector<entry> tail = snapshot(5,5000);
+    mp.insert_range(tail.begin(),tail.end());
+    std::cout<<mp.size()<<" "<<(*mp.begin()).first<<" ";
+    for(auto i=mp.find(3);i!=mp.end();++i) std::cout<<(*i).first<<" ";
+}
+void order_tester(){
+    if(STATUS)std::cout<<c[3];
+    order_run<sjtu::linked_hashmap<int,int> >();
+    order_run<sjtu::linked_hashmap<int,int,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage> >();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void input_tester(){
+    if(STATUS)std::cout<<c[4];
+    std::vector<entry> v = snapshot(3000,1);
+    sjtu::linked_hashmap<int,int> mp{reader(v),reader()};
+    sjtu::hashmap<int,int> plain;
+    plain.insert_range(reader(v),reader());
+    int k = 1;
+    for(auto it=mp.begin();it!=mp.end();++it,k+=3){
+        if((*it).first != k || (*plain.find(k)).second != (*it).second) fail();
+    }
+    std::cout<<mp.size()<<" "<<plain.size()<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void pool_tester(){
+    if(STATUS)std::cout<<c[5];
+    using pooled = sjtu::linked_hashmap<Integer,Matrix<int>,Hash,Equal,sjtu::chained_storage,
+        sjtu::prime_index,sjtu::pool_allocator<sjtu::pair<const Integer,Matrix<int> > > >;
+    std::vector<sjtu::pair<Integer,Matrix<int> > > v;
+    for(int i=0;i<5000;i++) v.push_back(sjtu::pair<Integer,Matrix<int> >(Integer(i),Matrix<int>(2,2,i)));
+    pooled mp;
+    mp.insert_range(v.begin(),v.end());
+    mp.insert(sjtu::pair<const Integer,Matrix<int> >(Integer(-1),Matrix<int>(1,1,0)));
+    size_t apart = 0;
+    auto prev = mp.begin(), it = prev;
+    for(++it;it!=mp.find(-1);++prev,++it){
+        const char *a = reinterpret_cast<const char *>(&*prev), *b = reinterpret_cast<const char *>(&*it);
+        if(b-a != (long)sizeof(pooled::Node)) apart++;
+    }
+    std::cout<<mp.size()<<" "<<apart<<" "<<mp.at(4999)[1][1]<<" ";
+    // the freed nodes are enough the second time, and existing keys
+    // set nothing aside
+    size_t carved = mp.get_allocator().pooled();
+    mp.clear();
+    mp.insert_range(v.begin(),v.end());
+    mp.insert_range(v.begin(),v.end());
+    if(mp.get_allocator().pooled() != carved) fail();
+    std::cout<<mp.size()<<" "<<carved<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+// its copy throws for one value
+class fussy {
+public:
+    int v;
+    fussy(int v) : v(v) {}
+    fussy(const fussy &rhs) : v(rhs.v) {
+        if(v == -7) throw v;
+    }
+    fussy &operator=(const fussy &rhs) {
+        if(rhs.v == -7) throw rhs.v;
+        v = rhs.v;
+        return *this;
+    }
+};
+
+template<class Map>
+void throw_run(int at){
+    std::vector<sjtu::pair<int,fussy> > v;
+    for(int i=0;i<100;i++) v.push_back(sjtu::pair<int,fussy>(i,fussy(i)));
+    v[at].second.v = -7;
+    Map mp;
+    mp.insert(sjtu::pair<const int,fussy>(50,fussy(0)));
+    bool thrown = false;
+    try{
+        mp.insert_range(v.begin(),v.end());
+    }catch(int){
+        thrown = true;
+    }
+    if(!thrown) fail();
+    // every key before the throwing one is in the list, in order
+    size_t walked = 0;
+    int last = -1;
+    for(auto it=mp.begin();it!=mp.end();++it,++walked) last = (*it).first;
+    if(walked != mp.size() || (at != 50 && mp.find(at) != mp.end())) fail();
+    std::cout<<mp.size()<<" "<<last<<" ";
+    mp.clear();
+    if(mp.begin() != mp.end()) fail();
+}
+void throw_tester(){
+    if(STATUS)std::cout<<c[6];
+    throw_run<sjtu::linked_hashmap<int,fussy> >(30);
+    throw_run<sjtu::linked_hashmap<int,fussy> >(50);
+    throw_run<sjtu::linked_hashmap<int,fussy,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage> >(80);
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("27.out","w",stdout);
+#endif
+    range_tester();
+    order_tester();
+    input_tester();
+    pool_tester();
+    throw_tester();
+    std::cout << c[7] << std::endl;
+}
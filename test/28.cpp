@@ -0,0 +1,172 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: hashmap moves its values",
+    "test2: linked_hashmap moves its values",
+    "test3: lru moves its values",
+    "test4: move-only values",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+};
+
+void fail(){
+    std::cout<<c[1]<<std::endl;
+    exit(0);
+}
+
+// a value that counts its copies
+class Tracked {
+public:
+    static int copies;
+    std::vector<int> data;
+    Tracked() {}
+    explicit Tracked(int n) : data(n, n) {}
+    Tracked(int n, int v) : data(n, v) {}
+    Tracked(const Tracked &rhs) : data(rhs.data) {copies++;}
+    Tracked(Tracked &&rhs) noexcept : data(std::move(rhs.data)) {}
+    Tracked &operator=(const Tracked &rhs) {data = rhs.data; copies++; return *this;}
+    Tracked &operator=(Tracked &&rhs) noexcept {data = std::move(rhs.data); return *this;}
+    long long sum() const {
+        long long s = 0;
+        for(int x : data) s += x;
+        return s;
+    }
+};
+int Tracked::copies = 0;
+
+using value_type = sjtu::pair<const int,Tracked>;
+
+template<class Map>
+long long fill(Map &mp){
+    for(int i=0;i<100;i++) mp.insert(value_type(i,Tracked(i)));
+    // existing keys: insert and insert_or_assign replace the value
+    for(int i=0;i<100;i+=2) mp.insert(value_type(i,Tracked(1,-i)));
+    for(int i=1;i<100;i+=4) mp.insert_or_assign(i,Tracked(2,i));
+    // try_emplace and emplace leave it alone
+    for(int i=0;i<150;i+=3){
+        auto res = mp.try_emplace(i,3,i);
+        if(res.second != (i >= 100)) fail();
+    }
+    for(int i=0;i<200;i+=5) mp.emplace(i,Tracked(4,i));
+    Tracked spare(5,5);
+    auto res = mp.insert_or_assign(1000,std::move(spare));
+    if(!res.second || (*res.first).second.sum() != 25 || !spare.data.empty()) fail();
+    long long sum = 0;
+    for(int i=0;i<=1000;i++){
+        auto it = mp.find(i);
+        if(it != mp.end()) sum += (*it).second.sum();
+    }
+    return sum;
+}
+
+template<class Map>
+void hashmap_run(){
+    Map mp;
+    Tracked::copies = 0;
+    long long sum = fill(mp);
+    if(Tracked::copies != 0) fail();
+    std::cout<<mp.size()<<" "<<sum<<" ";
+}
+void hashmap_tester(){
+    if(STATUS)std::cout<<c[2];
+    hashmap_run<sjtu::hashmap<int,Tracked> >();
+    hashmap_run<sjtu::hashmap<int,Tracked,std::hash<int>,std::equal_to<int>,sjtu::incremental_storage> >();
+    hashmap_run<sjtu::hashmap<int,Tracked,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage> >();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+template<class Map>
+void linked_run(){
+    Map mp;
+    Tracked::copies = 0;
+    long long sum = fill(mp);
+    if(Tracked::copies != 0) fail();
+    // the keys assigned last are at the tail, 1000 after them
+    int last = -1, before = -1;
+    for(auto it=mp.begin();it!=mp.end();++it){
+        before = last;
+        last = (*it).first;
+    }
+    std::cout<<mp.size()<<" "<<sum<<" "<<(*mp.begin()).first<<" "<<before<<" "<<last<<" ";
+}
+void linked_tester(){
+    if(STATUS)std::cout<<c[3];
+    linked_run<sjtu::linked_hashmap<int,Tracked> >();
+    linked_run<sjtu::linked_hashmap<int,Tracked,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage> >();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+template<class Policy>
+void lru_run(){
+    sjtu::basic_lru<int,Tracked,std::hash<int>,std::equal_to<int>,size_t,Policy> cache(64);
+    Tracked::copies = 0;
+    for(int i=0;i<100;i++) cache.save(value_type(i,Tracked(i)));
+    for(int i=50;i<100;i++) cache.save(i,Tracked(1,i));
+    for(int i=90;i<110;i++) cache.emplace(i,2,i);
+    for(int i=95;i<115;i++) cache.try_emplace(i,Tracked(3,i));
+    for(int i=100;i<120;i++) cache.insert_or_assign(i,Tracked(1,-i));
+    if(Tracked::copies != 0) fail();
+    long long sum = 0;
+    for(int i=0;i<120;i++){
+        if(Tracked *v = cache.get(i)) sum += v->sum();
+    }
+    std::cout<<cache.size()<<" "<<sum<<" ";
+}
+void lru_tester(){
+    if(STATUS)std::cout<<c[4];
+    lru_run<sjtu::lru_policy>();
+    lru_run<sjtu::clock_policy>();
+    lru_run<sjtu::arc_policy>();
+    lru_run<sjtu::w_tinylfu_policy>();
+    std::cout<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void move_only_tester(){
+    if(STATUS)std::cout<<c[5];
+    using ptr = std::unique_ptr<int>;
+    sjtu::hashmap<int,ptr> mp;
+    sjtu::hashmap<int,ptr,std::hash<int>,std::equal_to<int>,sjtu::swiss_storage> swiss;
+    sjtu::linked_hashmap<int,ptr> linked;
+    for(int i=0;i<50;i++){
+        mp.insert(sjtu::pair<const int,ptr>(i,ptr(new int(i))));
+        swiss.try_emplace(i,new int(i));
+        linked.emplace(i,ptr(new int(i)));
+    }
+    mp.insert_or_assign(3,ptr(new int(-3)));
+    swiss.insert(sjtu::pair<const int,ptr>(3,ptr(new int(-3))));
+    linked.insert(sjtu::pair<const int,ptr>(3,ptr(new int(-3))));
+    int sum = 0;
+    for(int i=0;i<50;i++){
+        sum += *(*mp.find(i)).second + *(*swiss.find(i)).second + *linked.at(i);
+    }
+    int last = -1;
+    for(auto it=linked.begin();it!=linked.end();++it) last = (*it).first;
+    std::cout<<sum<<" "<<last<<std::endl;
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("28.out","w",stdout);
+#endif
+    hashmap_tester();
+    linked_tester();
+    lru_tester();
+    move_only_tester();
+    std::cout << c[6] << std::endl;
+}
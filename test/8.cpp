@@ -40,10 +40,33 @@ void simple_lru_tester(){
     tester.print();
 }
 
+// a hit hands back the entry in place: the same address every time,
+// and it only changes the eviction order
+void lru_hit_tester(){
+    using value_type = sjtu::pair<Integer,Matrix<int> >;
+    sjtu::lru tester(10);
+    for(int i=0;i<10;i++){
+        tester.save(value_type( Integer(i),Matrix<int>(2,2,i)));
+    }
+    Matrix<int> *p = tester.get(Integer(3));
+    for(int i=0;i<10;i+=2){
+        tester.get(Integer(i));
+    }
+    if(tester.get(Integer(3)) != p || tester.get(Integer(42)) != nullptr){
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    for(int i=10;i<15;i++){
+        tester.save(value_type( Integer(i),Matrix<int>(2,2,i)));
+    }
+    tester.print();
+}
+
 int main(){
     #ifdef _OUTPUT_
     freopen("8.out","w",stdout);
 #endif
     simple_lru_tester();
+    lru_hit_tester();
     std::cout << c[7] << std::endl;
 }
\ No newline at end of file
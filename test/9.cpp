@@ -0,0 +1,152 @@
+#include "src.hpp"
+#if defined (_UNORDERED_MAP_)  || (defined (_LIST_)) || (defined (_MAP_)) || (defined (_SET_)) || (defined (_UNORDERED_SET_))||(defined (_GLIBCXX_MAP)) || (defined (_GLIBCXX_UNORDERED_MAP))
+BOOM :)
+#endif
+#include <iostream>
+#include <cassert>
+#include <string>
+// if this is 1, output yes or no
+//otherwise, output the exact num
+#define STATUS 0
+
+std::string c[]={
+    "   pass!",
+    "   error.",
+    "test1: swiss insert & expand",
+    "test2: swiss remove",
+    "test3: swiss find & correctness of insert and remove",
+    "test4: swiss constructor(), =",
+    "test5: swiss clear",
+    "Congratulations. Your submission has passed all correctness tests. Good job! :)",
+    "test6: swiss linked_hashmap order",
+};
+
+bool equal(Integer a,Integer b){
+    return a.val == b.val;
+}
+
+template<class mp>
+bool check(const mp &map,int n){
+    for(int i=0;i<n;i++){
+        typename mp::iterator it = map.find(Integer(i));
+        if(i%3==0){
+            if(it != map.end()) return false;
+        }
+        else if (i % 4 == 0){
+            if(it == map.end() || !equal(Integer(4 * i),(*it).second)) return false;
+        }
+        else{
+            if(it == map.end() || !equal(Integer(i),(*it).second)) return false;
+        }
+    }
+    return true;
+}
+
+void swiss_hashmap_tester(){
+    using value_type = sjtu::pair<Integer,Integer>;
+    using mp = sjtu::hashmap<Integer,Integer,Hash,Equal,sjtu::swiss_storage>;
+    const int n = 100000;
+    mp map;
+
+    //test: insert and expand
+    if(STATUS)std::cout<<c[2];
+    for(int i=0;i<n;i++){
+        map.insert(value_type(Integer(i),Integer(i)));
+    }
+    for(int i=0;i<n;i+=4){
+        if(map.insert(value_type(Integer(i),Integer(4*i))).second){
+            std::cout<<c[1]<<std::endl;
+            exit(0);
+        }
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+
+    //test: remove
+    if(STATUS)std::cout<<c[3];
+    for(int i=0;i<n;i+=3){
+        if(!map.remove(Integer(i))){
+            std::cout<<c[1]<<std::endl;
+            exit(0);
+        }
+    }
+    if(map.remove(Integer(0))){
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+
+    //test: find
+    if(STATUS)std::cout<<c[4];
+    if(!check(map,n)){
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    for(int i=0;i<30;i++){
+        mp::iterator it = map.find(Integer(i));
+        if(it != map.end())
+            std::cout<<(*it).second.val<<std::endl;
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+
+    //test: reuse the deleted slots
+    for(int i=0;i<n;i+=3){
+        map.insert(value_type(Integer(i),Integer(i)));
+        map.remove(Integer(i));
+    }
+    std::cout<<map.num_elem<<std::endl;
+
+    //test: constructor(), =
+    if(STATUS)std::cout<<c[5];
+    mp map2(map);
+    map2.clear();
+    map2 = map;
+    if(!check(map2,n)){
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+
+    //test: clear
+    if(STATUS)std::cout<<c[6];
+    map.clear();
+    map.clear();
+    if(map.find(Integer(1)) != map.end()){
+        std::cout<<c[1]<<std::endl;
+        exit(0);
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+void swiss_linked_hashmap_tester(){
+    using value_type = sjtu::pair<Integer,Matrix<int> >;
+    using mp = sjtu::linked_hashmap<Integer,Matrix<int>,Hash,Equal,sjtu::swiss_storage>;
+    const int n = 40;
+    if(STATUS)std::cout<<c[8];
+    mp map;
+    for(int i=0;i<n;i++){
+        map.insert(value_type(Integer(i),Matrix<int>(1,1,i)));
+    }
+    for(int i=0;i<n;i+=4){
+        map.insert(value_type(Integer(i),Matrix<int>(1,1,4*i)));
+    }
+    for(mp::iterator it = map.begin();it!=map.end();){
+        mp::iterator tmpit = it;
+        it++;
+        if((*tmpit).first.val % 3 == 0) map.remove(tmpit);
+    }
+    mp map2(map);
+    std::cout<<map2.size()<<" "<<map2.count(Integer(4))<<" "<<map2.count(Integer(3))<<std::endl;
+    for(mp::const_iterator it = map2.cbegin();it!=map2.cend();++it){
+        std::cout<<(*it).first.val<<" "<<(*it).second[0][0]<<std::endl;
+    }
+    if(STATUS)std::cout<<c[0]<<std::endl;
+}
+
+int main(){
+#ifdef _OUTPUT_
+    freopen("9.out","w",stdout);
+#endif
+    swiss_hashmap_tester();
+    swiss_linked_hashmap_tester();
+    std::cout << c[7] << std::endl;
+}